@@ -0,0 +1,251 @@
+/*
+ * DeadlineMonitor.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Deadline Monitor
+ * This file provides the implementation for the DeadlineMonitor class which
+ * raises alerts for tasks in the background while a session is running.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/foreach.hpp>
+
+// for running the hook command
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "DeadlineMonitor.h"
+
+namespace {
+    // Names for each stage, passed to the hook command as its first argument
+    const char *STAGE_NAMES[] = { "released", "due-soon", "infeasible" };
+}
+
+DeadlineMonitor::DeadlineMonitor(boost::posix_time::time_duration lead,
+                                 std::string hookCommand)
+: lead(lead), hookCommand(hookCommand),
+epoch(boost::posix_time::second_clock::local_time()), wheel(0),
+wakeTick(0), stopping(false), thread(&DeadlineMonitor::run, this) {
+}
+
+DeadlineMonitor::~DeadlineMonitor() {
+    {
+        boost::lock_guard<boost::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    thread.join();
+
+    typedef std::pair<Task * const, Alarm *> AlarmEntry;
+    BOOST_FOREACH(AlarmEntry &entry, alarms) {
+        delete entry.second;
+    }
+}
+
+/* Arm a timer for the next alert of a task, replacing any existing timer. */
+void DeadlineMonitor::watch(Task *task) {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    if (arm(task, boost::posix_time::second_clock::local_time())) {
+        wakeup.notify_all();
+    }
+}
+
+/* Watch a batch of tasks, such as an import, under one lock. */
+void DeadlineMonitor::watch(const std::vector<Task *> &tasks) {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    boost::posix_time::ptime now =
+    boost::posix_time::second_clock::local_time();
+    alarms.reserve(alarms.size() + tasks.size());
+    bool earlier = false;
+    BOOST_FOREACH(Task *task, tasks)
+    {
+        earlier = arm(task, now) || earlier;
+    }
+    if (earlier) {
+        wakeup.notify_all();
+    }
+}
+
+void DeadlineMonitor::unwatch(Task *task) {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    disarm(task);
+}
+
+void DeadlineMonitor::unwatch(const std::vector<Task *> &tasks) {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    BOOST_FOREACH(Task *task, tasks)
+    {
+        disarm(task);
+    }
+}
+
+/* Wait for timers to expire and raise their alerts until stopped. */
+void DeadlineMonitor::run() {
+    boost::unique_lock<boost::mutex> lock(mutex);
+    while (!stopping) {
+        // The wheel is read again before the next wait, so there is no need
+        // to wake the thread until then.
+        wakeTick = 0;
+        boost::posix_time::time_duration sinceEpoch =
+        boost::posix_time::second_clock::local_time() - epoch;
+        unsigned long long now = sinceEpoch.is_negative() ? 0 :
+        sinceEpoch.total_seconds();
+        std::vector<TimingWheel::Timer *> expired;
+        wheel.advance(now, expired);
+
+        std::vector<Alert> alerts;
+        BOOST_FOREACH(TimingWheel::Timer *timer, expired) {
+            Alarm *alarm = static_cast<Alarm *>(timer);
+            Alert alert;
+            alert.stage = alarm->stage;
+            alert.title = alarm->task->getTitle();
+            alert.due = alarm->task->getInterval()->end();
+            alerts.push_back(alert);
+            if (!armNextStage(alarm, alarm->time, alarm->stage)) {
+                alarms.erase(alarm->task);
+                delete alarm;
+            }
+        }
+
+        // Tasks may be changed while the alerts are dispatched, which is why
+        // the alerts hold copies of the task data.
+        if (!alerts.empty()) {
+            lock.unlock();
+            BOOST_FOREACH(Alert &alert, alerts) {
+                dispatch(alert);
+            }
+            lock.lock();
+            continue;
+        }
+
+        // Sleep until the wheel has something to do, or a task is watched
+        // with an earlier alert.
+        if (wheel.empty()) {
+            wakeTick = std::numeric_limits<unsigned long long>::max();
+            wakeup.wait(lock);
+        }
+        else {
+            unsigned long long next = wheel.nextTick();
+            if (next > now) {
+                wakeTick = next;
+                wakeup.timed_wait(lock, boost::posix_time::
+                                  seconds((long)(next - now)));
+            }
+        }
+    }
+}
+
+/*
+ * Arm a timer for the next alert of a task after the given time, replacing
+ * any existing timer. Returns true if the thread must be woken because the
+ * alert comes before it would wake by itself.
+ */
+bool DeadlineMonitor::arm(Task *task, boost::posix_time::ptime now) {
+    boost::unordered_map<Task *, Alarm *>::iterator it = alarms.find(task);
+    Alarm *alarm;
+    if (it != alarms.end()) {
+        alarm = it->second;
+        wheel.cancel(alarm);
+    }
+    else {
+        alarm = new Alarm();
+        alarm->task = task;
+    }
+    // Alerts which are already in the past are not raised.
+    if (!armNextStage(alarm, now, STAGE_COUNT)) {
+        alarms.erase(task);
+        delete alarm;
+        return false;
+    }
+    alarms[task] = alarm;
+    return toTick(alarm->time) < wakeTick;
+}
+
+void DeadlineMonitor::disarm(Task *task) {
+    boost::unordered_map<Task *, Alarm *>::iterator it = alarms.find(task);
+    if (it != alarms.end()) {
+        wheel.cancel(it->second);
+        delete it->second;
+        alarms.erase(it);
+    }
+}
+
+/*
+ * Arm the alarm for the earliest stage which comes after the given time and
+ * stage. Returns false if the task has no alerts left.
+ */
+bool DeadlineMonitor::armNextStage(Alarm *alarm,
+                                   boost::posix_time::ptime after,
+                                   int afterStage) {
+    bool found = false;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        Stage stage = (Stage)i;
+        boost::posix_time::ptime time = stageTime(alarm->task, stage);
+        if (time.is_special() || time < after
+            || (time == after && stage <= afterStage)) {
+            continue;
+        }
+        if (!found || time < alarm->time) {
+            alarm->stage = stage;
+            alarm->time = time;
+            found = true;
+        }
+    }
+    if (found) {
+        wheel.arm(alarm, toTick(alarm->time));
+    }
+    return found;
+}
+
+boost::posix_time::ptime DeadlineMonitor::stageTime(Task *task, Stage stage) {
+    switch (stage) {
+        case RELEASED:
+            return task->getInterval()->begin();
+        case DUE_SOON:
+            return task->getInterval()->end() - lead;
+        case INFEASIBLE: // The latest time the task could be started
+            return task->getInterval()->end() - *task->getDuration();
+        default:
+            return boost::posix_time::ptime();
+    }
+}
+
+/* Convert a time to a tick on the wheel, rounding up to the next second. */
+unsigned long long DeadlineMonitor::toTick(boost::posix_time::ptime time) {
+    if (time <= epoch) {
+        return 0;
+    }
+    boost::posix_time::time_duration sinceEpoch = time - epoch;
+    unsigned long long tick = sinceEpoch.total_seconds();
+    if (sinceEpoch > boost::posix_time::seconds((long)tick)) {
+        tick++;
+    }
+    return tick;
+}
+
+/* Print the alert, or run the hook command with it. */
+void DeadlineMonitor::dispatch(const Alert &alert) {
+    std::string due = boost::posix_time::to_simple_string(alert.due);
+    if (hookCommand.empty()) {
+        std::cout << std::endl << "[" << STAGE_NAMES[alert.stage] << "] "
+        << alert.title << " (" << due << ")" << std::endl;
+        return;
+    }
+    // The alert is passed as arguments rather than pasted into the command,
+    // so titles never need quoting. The hook sees them as $1, $2 and $3.
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", hookCommand.c_str(), "timefield-alert",
+              STAGE_NAMES[alert.stage], alert.title.c_str(), due.c_str(),
+              (char *)NULL);
+        _exit(127);
+    }
+    else if (pid > 0) {
+        waitpid(pid, NULL, 0);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * DeadlineMonitor.h
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Deadline Monitor
+ * This file provides the definitions for the DeadlineMonitor class which
+ * raises alerts for tasks in the background while a session is running.
+ */
+
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/unordered_map.hpp>
+#include <string>
+#include <vector>
+
+#include "Task.h"
+#include "TimingWheel.h"
+
+/*
+ * Each watched task has one timer on a timing wheel, armed for its next
+ * alert: when it is released, when its due date is approaching, and when
+ * there is no longer enough time left to finish it. Alerts are printed to
+ * stdout, or passed to a hook command if one is given.
+ */
+class DeadlineMonitor {
+private:
+    enum Stage { RELEASED, DUE_SOON, INFEASIBLE, STAGE_COUNT };
+
+    struct Alarm : public TimingWheel::Timer {
+        Task *task;
+        Stage stage; // The alert this timer is armed for
+        boost::posix_time::ptime time;
+    };
+
+    struct Alert {
+        Stage stage;
+        std::string title;
+        boost::posix_time::ptime due;
+    };
+
+    boost::posix_time::time_duration lead; // Warning time before a due date
+    std::string hookCommand;
+    boost::posix_time::ptime epoch; // The time of tick 0 on the wheel
+    TimingWheel wheel;
+    boost::unordered_map<Task *, Alarm *> alarms;
+    boost::mutex mutex; // Guards everything above
+    boost::condition_variable wakeup;
+    unsigned long long wakeTick; // When the thread will next wake by itself
+    bool stopping;
+    boost::thread thread;
+
+    void run();
+    bool arm(Task *task, boost::posix_time::ptime now);
+    void disarm(Task *task);
+    bool armNextStage(Alarm *alarm, boost::posix_time::ptime after,
+                      int afterStage);
+    boost::posix_time::ptime stageTime(Task *task, Stage stage);
+    unsigned long long toTick(boost::posix_time::ptime time);
+    void dispatch(const Alert &alert);
+
+public:
+    DeadlineMonitor(boost::posix_time::time_duration lead,
+                    std::string hookCommand);
+    ~DeadlineMonitor();
+    void watch(Task *task);
+    void watch(const std::vector<Task *> &tasks);
+    void unwatch(Task *task);
+    void unwatch(const std::vector<Task *> &tasks);
+};
+
+#endif
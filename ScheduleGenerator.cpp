@@ -0,0 +1,114 @@
+/*
+ * ScheduleGenerator.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Schedule Generator
+ * This file provides the implementation for the ScheduleGenerator class which
+ * produces a schedule for the working interval one slot at a time.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "ScheduleGenerator.h"
+#include "Stats.h"
+
+bool ScheduleGenerator::LaterDue::operator()(const Job &a,
+                                             const Job &b) const {
+    return a.task->getInterval()->end() > b.task->getInterval()->end();
+}
+
+bool ScheduleGenerator::EarlierRelease::operator()(const Job &a,
+                                                  const Job &b) const {
+    return a.release < b.release;
+}
+
+ScheduleGenerator::ScheduleGenerator(const std::vector<Task *> &tasks,
+                                     const boost::posix_time::time_period
+                                     &workingInterval) {
+    now = workingInterval.begin();
+    end = workingInterval.end();
+    nextPending = 0;
+    for (int i = 0; i < tasks.size(); i++) {
+        boost::posix_time::time_period *interval = tasks[i]->getInterval();
+        // Only tasks which can be worked on in the working interval are
+        // scheduled.
+        if (!interval->intersects(workingInterval)
+            || tasks[i]->getDuration()->is_negative()
+            || *tasks[i]->getDuration() == boost::posix_time::seconds(0)) {
+            continue;
+        }
+        Job job;
+        job.id = i + 1; // Friendly numbers, starting at 1
+        job.task = tasks[i];
+        job.release = std::max(interval->begin(), now);
+        job.remaining = *tasks[i]->getDuration();
+        pending.push_back(job);
+    }
+    // Keep the list order for tasks released at the same time.
+    std::stable_sort(pending.begin(), pending.end(), EarlierRelease());
+}
+
+/* Move every job released by the current time into the ready queue. */
+void ScheduleGenerator::releaseJobs() {
+    while (nextPending < pending.size()
+           && pending[nextPending].release <= now) {
+        ready.push(pending[nextPending]);
+        nextPending++;
+    }
+}
+
+/*
+ * Compute the next slot of the schedule. Returns false once the working
+ * interval is over or there is nothing left to schedule.
+ */
+bool ScheduleGenerator::next(ScheduleSlot &slot) {
+    STATS_TIMER(STATS_SCHEDULE);
+    releaseJobs();
+    // If nothing is ready, skip ahead to the next release.
+    if (ready.empty()) {
+        if (nextPending == pending.size()) {
+            return false;
+        }
+        now = pending[nextPending].release;
+        releaseJobs();
+    }
+    if (now >= end) {
+        return false;
+    }
+
+    Job job = ready.top();
+    ready.pop();
+    boost::posix_time::ptime begin = now;
+    while (true) {
+        // Run the job until it is finished, the working interval ends, or
+        // another job is released.
+        boost::posix_time::ptime stop = now + job.remaining;
+        if (nextPending < pending.size()
+            && pending[nextPending].release < stop) {
+            stop = pending[nextPending].release;
+        }
+        if (stop > end) {
+            stop = end;
+        }
+        job.remaining -= stop - now;
+        now = stop;
+        releaseJobs();
+        // Keep extending this slot unless the newly released jobs include
+        // one with an earlier due date.
+        if (job.remaining <= boost::posix_time::seconds(0) || now >= end
+            || (!ready.empty() && LaterDue()(job, ready.top()))) {
+            break;
+        }
+    }
+    if (job.remaining > boost::posix_time::seconds(0)) {
+        ready.push(job);
+    }
+
+    STATS_COUNT(STATS_SLOTS_GENERATED, 1);
+    slot.id = job.id;
+    slot.task = job.task;
+    slot.period = boost::posix_time::time_period(begin, now);
+    return true;
+}
@@ -0,0 +1,66 @@
+/*
+ * ScheduleGenerator.h
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Schedule Generator
+ * This file provides the definitions for the ScheduleGenerator class which
+ * produces a schedule for the working interval one slot at a time.
+ */
+
+#ifndef SCHEDULE_GENERATOR_H
+#define SCHEDULE_GENERATOR_H
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <queue>
+#include <vector>
+
+#include "Task.h"
+
+/* A block of time in the schedule assigned to a single task. */
+struct ScheduleSlot {
+    int id; // Friendly task number, as shown by the list command
+    Task *task;
+    boost::posix_time::time_period period;
+
+    ScheduleSlot() : id(-1), task(NULL),
+    period(boost::posix_time::ptime(), boost::posix_time::ptime()) {}
+};
+
+/*
+ * Generates an earliest-deadline-first schedule lazily. Each call to next()
+ * computes only the following slot, so memory use depends on the number of
+ * tasks and not on the length of the working interval.
+ */
+class ScheduleGenerator {
+private:
+    // A task which still needs time scheduled.
+    struct Job {
+        int id;
+        Task *task;
+        boost::posix_time::ptime release;
+        boost::posix_time::time_duration remaining;
+    };
+    // Orders the ready queue so the job with the earliest due date is on top.
+    struct LaterDue {
+        bool operator()(const Job &a, const Job &b) const;
+    };
+    // Orders unreleased jobs by the time they become available.
+    struct EarlierRelease {
+        bool operator()(const Job &a, const Job &b) const;
+    };
+
+    std::vector<Job> pending; // Unreleased jobs, sorted by release date
+    std::vector<Job>::size_type nextPending;
+    std::priority_queue<Job, std::vector<Job>, LaterDue> ready;
+    boost::posix_time::ptime now;
+    boost::posix_time::ptime end;
+
+    void releaseJobs();
+
+public:
+    ScheduleGenerator(const std::vector<Task *> &tasks,
+                      const boost::posix_time::time_period &workingInterval);
+    bool next(ScheduleSlot &slot);
+};
+
+#endif
@@ -9,8 +9,11 @@
 
 #include <string>
 #include <vector>
+#include <queue>
+#include <algorithm>
 #include <exception>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
 
 // for loading tasks.xml
 #include <boost/property_tree/ptree.hpp>
@@ -18,19 +21,115 @@
 #include <boost/foreach.hpp>
 
 #include "Scheduler.h"
+#include "DeadlineMonitor.h"
+#include "Stats.h"
 
-Scheduler::Scheduler(std::string tasksFilename) {
-    Scheduler::tasksFilename = tasksFilename;
+#define DEFAULT_HISTORY_LIMIT (64ULL * 1024 * 1024) // bytes of undo history
+
+Scheduler::Scheduler(std::vector<std::string> tasksFilenames) {
+    monitor = NULL;
+    loaded = false;
+    merged = false;
+    historyBytes = 0;
+    historyLimit = DEFAULT_HISTORY_LIMIT;
     // Set working interval to the current day
     workingInterval = new boost::posix_time::
     time_period(boost::posix_time::ptime(boost::gregorian::day_clock::
                                          local_day()),
                 boost::posix_time::hours(24));
     
-    // Read persistent task data from file
+    BOOST_FOREACH(std::string &filename, tasksFilenames)
+    {
+        TaskFile *file = new TaskFile();
+        file->filename = filename;
+        files.push_back(file);
+    }
+}
+
+Scheduler::~Scheduler() {
+    // Write persistent task data to the files which have changed. The tasks
+    // are deleted along with the last collection which holds them.
+    BOOST_FOREACH(TaskFile *file, files)
+    {
+        if (loaded && !file->tasks.isSameAs(file->saved)) {
+            saveFile(file->filename, file->tasks);
+        }
+        delete file;
+    }
+    delete workingInterval;
+}
+
+/*
+ * Read persistent task data from the files, several at a time. This is put
+ * off until the tasks are first needed, so that commands which do not use
+ * them start quickly.
+ */
+void Scheduler::load() {
+    if (loaded) {
+        return;
+    }
+    int threadCount = std::min<int>(boost::thread::hardware_concurrency(),
+                                    files.size());
+    if (threadCount <= 1) {
+        BOOST_FOREACH(TaskFile *file, files)
+        {
+            loadFile(file);
+        }
+    }
+    else {
+        int nextFile = 0;
+        boost::mutex mutex;
+        FileLoader loader;
+        loader.files = &files;
+        loader.nextFile = &nextFile;
+        loader.mutex = &mutex;
+        boost::thread_group threads;
+        for (int i = 0; i < threadCount; i++) {
+            threads.create_thread(loader);
+        }
+        threads.join_all();
+    }
+    loaded = true;
+}
+
+void Scheduler::FileLoader::operator()() {
+    while (true) {
+        TaskFile *file;
+        {
+            boost::lock_guard<boost::mutex> lock(*mutex);
+            if (*nextFile == files->size()) {
+                return;
+            }
+            file = (*files)[(*nextFile)++];
+        }
+        loadFile(file);
+    }
+}
+
+bool Scheduler::EarlierRelease::operator()(Task *a, Task *b) const {
+    if (a->getInterval()->begin() != b->getInterval()->begin()) {
+        return a->getInterval()->begin() < b->getInterval()->begin();
+    }
+    return a->getInterval()->end() < b->getInterval()->end();
+}
+
+bool Scheduler::LaterCursor::operator()(const Cursor &a,
+                                        const Cursor &b) const {
+    Task *taskA = (*lists)[a.first][a.second];
+    Task *taskB = (*lists)[b.first][b.second];
+    if (EarlierRelease()(taskB, taskA)) {
+        return true;
+    }
+    return !EarlierRelease()(taskA, taskB) && a.first > b.first;
+}
+
+/* Read the tasks from a file into a sorted collection. */
+void Scheduler::loadFile(TaskFile *file) {
+    STATS_TIMER(STATS_LOAD);
+    std::vector<Task *> tasks;
     try {
         boost::property_tree::ptree pt;
-        read_xml(tasksFilename, pt);
+        read_xml(file->filename, pt);
         BOOST_FOREACH(boost::property_tree::ptree::value_type &v,
                       pt.get_child("tasks"))
         {
@@ -53,19 +152,37 @@ Scheduler::Scheduler(std::string tasksFilename) {
             new boost::posix_time::
             time_duration(boost::posix_time::
                           duration_from_string(durationString));
-            addTask(new Task(title, notes, interval, duration, NULL));
+            tasks.push_back(new Task(title, notes, interval, duration,
+                                     NULL));
         }
+        STATS_COUNT(STATS_TASKS_LOADED, tasks.size());
     }
     catch (...) {
         // Failed to read from file.
-        taskList.clear();
+        BOOST_FOREACH(Task *task, tasks)
+        {
+            delete task;
+        }
+        tasks.clear();
     }
+    // Files written by earlier versions may not be in order, so the
+    // collection sorts them.
+    file->tasks = TaskCollection().insertAll(tasks);
+    file->saved = file->tasks;
 }
 
-Scheduler::~Scheduler() {
-    // Write persistent task data to file
+/*
+ * Write a version of a file's tasks to it. The version is a snapshot, so it
+ * is not affected by later changes.
+ */
+void Scheduler::saveFile(const std::string &filename,
+                         const TaskCollection &snapshot) {
+    STATS_TIMER(STATS_SAVE);
+    STATS_COUNT(STATS_TASKS_SAVED, snapshot.size());
+    std::vector<Task *> tasks;
+    snapshot.getTasks(tasks);
     boost::property_tree::ptree pt;
-    BOOST_FOREACH(Task *task, taskList)
+    BOOST_FOREACH(Task *task, tasks)
     {
         std::string title, notes, releaseDateString, dueDateString, 
         durationString;
@@ -85,11 +202,48 @@ Scheduler::~Scheduler() {
         subtree.put("due-date", dueDateString);
         subtree.put("duration", durationString);
         pt.add_child("tasks.task", subtree);
-        delete task;
     }
     
-    write_xml(tasksFilename, pt);
-    delete workingInterval;
+    write_xml(filename, pt);
+}
+
+/*
+ * Rebuild the task list with a k-way merge of the files, which are already
+ * sorted. Ties go to the earlier file.
+ */
+void Scheduler::merge() {
+    if (merged) {
+        return;
+    }
+    load();
+    std::vector<std::vector<Task *> > lists(files.size());
+    LaterCursor later;
+    later.lists = &lists;
+    std::priority_queue<Cursor, std::vector<Cursor>, LaterCursor>
+    cursors(later);
+    std::vector<Task *>::size_type taskCount = 0;
+    for (int i = 0; i < files.size(); i++) {
+        files[i]->tasks.getTasks(lists[i]);
+        taskCount += lists[i].size();
+        if (!lists[i].empty()) {
+            cursors.push(Cursor(i, 0));
+        }
+    }
+
+    taskList.clear();
+    taskFiles.clear();
+    taskList.reserve(taskCount);
+    taskFiles.reserve(taskCount);
+    while (!cursors.empty()) {
+        Cursor cursor = cursors.top();
+        cursors.pop();
+        taskList.push_back(lists[cursor.first][cursor.second]);
+        taskFiles.push_back(cursor.first);
+        if (++cursor.second < lists[cursor.first].size()) {
+            cursors.push(cursor);
+        }
+    }
+    merged = true;
 }
 
 boost::posix_time::time_period *Scheduler::getWorkingInterval() {
@@ -103,20 +257,163 @@ void Scheduler::setWorkingInterval(boost::posix_time::time_period *interval) {
 }
 
 void Scheduler::addTask(Task *task) {
-    taskList.push_back(task);
+    load();
+    change(0, files[0]->tasks.insert(task), std::vector<Task *>(1, task),
+           std::vector<Task *>());
+}
+
+/*
+ * Add a batch of tasks at once, such as the result of an import. The batch
+ * is merged into the first file in one pass, and is undone as one change.
+ */
+void Scheduler::addTasks(const std::vector<Task *> &tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    load();
+    change(0, files[0]->tasks.insertAll(tasks), tasks, std::vector<Task *>());
 }
 
+/* Delete a task from the file it came from. */
 void Scheduler::deleteTask(int i) {
-    if (i - 1 >= taskList.size()) {
+    merge();
+    if (i < 1 || i > taskList.size()) {
         throw std::exception();
     }
-    taskList.erase(taskList.begin() + i - 1);
+    Task *task = taskList[i - 1];
+    int file = taskFiles[i - 1];
+    change(file, files[file]->tasks.erase(task), std::vector<Task *>(),
+           std::vector<Task *>(1, task));
+}
+
+/* Undo the most recent change. Returns false if there is nothing to undo. */
+bool Scheduler::undo() {
+    if (undoHistory.empty()) {
+        return false;
+    }
+    apply(undoHistory.back(), true);
+    redoHistory.push_back(undoHistory.back());
+    undoHistory.pop_back();
+    return true;
+}
+
+/* Redo the last undone change. Returns false if there is nothing to redo. */
+bool Scheduler::redo() {
+    if (redoHistory.empty()) {
+        return false;
+    }
+    apply(redoHistory.back(), false);
+    undoHistory.push_back(redoHistory.back());
+    redoHistory.pop_back();
+    return true;
+}
+
+/* Limit the memory used by the undo history, or 0 for no limit. */
+void Scheduler::setHistoryLimit(unsigned long long bytes) {
+    historyLimit = bytes;
+    trimHistory();
+}
+
+/*
+ * Replace a file's tasks with a new version and remember the change. A
+ * version which is the same as the current one, such as an erase which
+ * found nothing, is not a change and leaves the history alone.
+ */
+void Scheduler::change(int file, const TaskCollection &after,
+                       const std::vector<Task *> &added,
+                       const std::vector<Task *> &removed) {
+    if (after.isSameAs(files[file]->tasks)) {
+        return;
+    }
+    Change change;
+    change.file = file;
+    change.before = files[file]->tasks;
+    change.after = after;
+    change.added = added;
+    change.removed = removed;
+    change.bytes = after.getChangeBytes()
+    + (added.size() + removed.size()) * sizeof(Task *);
+    apply(change, false);
+
+    // A new change replaces anything which was undone.
+    BOOST_FOREACH(Change &undone, redoHistory)
+    {
+        historyBytes -= undone.bytes;
+    }
+    redoHistory.clear();
+    undoHistory.push_back(change);
+    historyBytes += change.bytes;
+    trimHistory();
+}
+
+/* Move a file to the version before or after a change. */
+void Scheduler::apply(const Change &change, bool undo) {
+    files[change.file]->tasks = undo ? change.before : change.after;
+    merged = false;
+    if (monitor != NULL) {
+        monitor->unwatch(undo ? change.added : change.removed);
+        monitor->watch(undo ? change.removed : change.added);
+    }
+}
+
+/* Forget the oldest changes until the history fits in its limit. */
+void Scheduler::trimHistory() {
+    while (historyLimit != 0 && historyBytes > historyLimit) {
+        if (!undoHistory.empty()) {
+            historyBytes -= undoHistory.front().bytes;
+            undoHistory.pop_front();
+        }
+        else if (!redoHistory.empty()) {
+            historyBytes -= redoHistory.front().bytes;
+            redoHistory.pop_front();
+        }
+        else {
+            break;
+        }
+    }
 }
 
 Task *Scheduler::getTask(int i) {
+    merge();
+    if (i < 1 || i > taskList.size()) {
+        throw std::exception();
+    }
     return taskList[i - 1];
 }
 
 std::vector<Task *> Scheduler::getTaskList() {
+    merge();
     return taskList;
 }
+
+std::string Scheduler::getTaskFilename(int i) {
+    merge();
+    if (i < 1 || i > taskList.size()) {
+        throw std::exception();
+    }
+    return files[taskFiles[i - 1]]->filename;
+}
+
+int Scheduler::getFileCount() {
+    return files.size();
+}
+
+/* 
+ * Watch every task with the given monitor, which may be NULL to stop
+ * watching. The monitor is not owned by the Scheduler.
+ */
+void Scheduler::setDeadlineMonitor(DeadlineMonitor *monitor) {
+    load();
+    BOOST_FOREACH(TaskFile *file, files)
+    {
+        std::vector<Task *> tasks;
+        file->tasks.getTasks(tasks);
+        if (Scheduler::monitor != NULL) {
+            Scheduler::monitor->unwatch(tasks);
+        }
+        if (monitor != NULL) {
+            monitor->watch(tasks);
+        }
+    }
+    Scheduler::monitor = monitor;
+}
@@ -11,25 +11,101 @@
 #define SCHEDULER_H
 
 #include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/mutex.hpp>
 #include <string>
+#include <vector>
+#include <deque>
 
 #include "Task.h"
+#include "TaskCollection.h"
 
+class DeadlineMonitor;
+
+/*
+ * Tasks may come from several files. Each file keeps its tasks sorted by
+ * release date and then due date, and the task list is a merge of the
+ * files in the same order. Changes are written back to the file each task
+ * came from; new tasks go to the first file.
+ *
+ * Every change replaces a file's TaskCollection with a new version and
+ * keeps the old one for undo, so the history costs memory in proportion to
+ * what changed. The oldest changes are forgotten once the history uses more
+ * than its limit.
+ */
 class Scheduler {
 private:
+    struct TaskFile {
+        std::string filename;
+        TaskCollection tasks;
+        TaskCollection saved; // The version last read from or written to disk
+    };
+    // A change to one file which can be undone and redone.
+    struct Change {
+        int file;
+        TaskCollection before;
+        TaskCollection after;
+        std::vector<Task *> added;
+        std::vector<Task *> removed;
+        unsigned long long bytes;
+    };
+    // Loads the files on one thread of the loading pool.
+    struct FileLoader {
+        std::vector<TaskFile *> *files;
+        int *nextFile;
+        boost::mutex *mutex;
+        void operator()();
+    };
+    // Orders tasks by release date and then due date.
+    struct EarlierRelease {
+        bool operator()(Task *a, Task *b) const;
+    };
+    // A file and a position in it, for merging the files.
+    typedef std::pair<int, std::vector<Task *>::size_type> Cursor;
+    // Orders cursors so the one with the earliest task is on top.
+    struct LaterCursor {
+        const std::vector<std::vector<Task *> > *lists;
+        bool operator()(const Cursor &a, const Cursor &b) const;
+    };
+
     boost::posix_time::time_period *workingInterval;
-    std::vector<Task *> taskList;
-    std::string tasksFilename;
+    std::vector<TaskFile *> files;
+    std::vector<Task *> taskList; // All files merged, rebuilt when needed
+    std::vector<int> taskFiles; // The file of each task in taskList
+    bool loaded; // Whether the files have been read
+    bool merged; // Whether taskList is up to date
+    DeadlineMonitor *monitor; // Raises alerts for the tasks, if set
+    std::deque<Change> undoHistory;
+    std::deque<Change> redoHistory;
+    unsigned long long historyBytes;
+    unsigned long long historyLimit; // 0 for no limit
+
+    void load();
+    static void loadFile(TaskFile *file);
+    static void saveFile(const std::string &filename,
+                         const TaskCollection &tasks);
+    void merge();
+    void change(int file, const TaskCollection &after,
+                const std::vector<Task *> &added,
+                const std::vector<Task *> &removed);
+    void apply(const Change &change, bool undo);
+    void trimHistory();
 
 public:
-    Scheduler(std::string tasksFilename);
+    Scheduler(std::vector<std::string> tasksFilenames);
     ~Scheduler();
     boost::posix_time::time_period *getWorkingInterval();    
     void setWorkingInterval(boost::posix_time::time_period *);
     void addTask(Task *task);
+    void addTasks(const std::vector<Task *> &tasks);
     void deleteTask(int i);
+    bool undo();
+    bool redo();
+    void setHistoryLimit(unsigned long long bytes);
     Task *getTask(int i);
     std::vector<Task *> getTaskList();
+    std::string getTaskFilename(int i);
+    int getFileCount();
+    void setDeadlineMonitor(DeadlineMonitor *monitor);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+/*
+ * Stats.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Stats
+ * This file provides the implementation for the lightweight instrumentation
+ * used to measure the hot paths of TimeField.
+ */
+
+#ifdef TIMEFIELD_STATS
+
+#include <iostream>
+#include <iomanip> // for aligning the output columns
+#include <cstdlib> // for calloc, malloc and free
+#include <new>
+#include <pthread.h>
+#include <time.h>
+
+#include "Stats.h"
+
+namespace {
+    // Bucket b holds latencies in [2^(b-1), 2^b) nanoseconds.
+    const int BUCKET_COUNT = 65;
+
+    const char *TIMER_NAMES[STATS_TIMER_COUNT] = {
+        "load", "parse", "query", "schedule", "save", "import"
+    };
+    const char *COUNTER_NAMES[STATS_COUNTER_COUNT] = {
+        "allocations", "tasks-loaded", "tasks-saved", "slots-generated"
+    };
+
+    struct TimerStats {
+        unsigned long long count;
+        unsigned long long total;
+        unsigned long long max;
+        unsigned long long buckets[BUCKET_COUNT];
+    };
+
+    struct ThreadStats {
+        TimerStats timers[STATS_TIMER_COUNT];
+        unsigned long long counters[STATS_COUNTER_COUNT];
+        ThreadStats *next;
+    };
+
+    // Every block ever created, so that threads which have exited are still
+    // included. The lock is only taken the first time a thread records.
+    // Blocks are allocated with calloc because operator new is counted.
+    ThreadStats *allThreadStats = NULL;
+    pthread_mutex_t allThreadStatsLock = PTHREAD_MUTEX_INITIALIZER;
+    __thread ThreadStats *threadStats = NULL;
+
+    ThreadStats *getThreadStats() {
+        if (threadStats == NULL) {
+            threadStats = (ThreadStats *)calloc(1, sizeof(ThreadStats));
+            if (threadStats == NULL) {
+                abort();
+            }
+            pthread_mutex_lock(&allThreadStatsLock);
+            threadStats->next = allThreadStats;
+            allThreadStats = threadStats;
+            pthread_mutex_unlock(&allThreadStatsLock);
+        }
+        return threadStats;
+    }
+
+    int bucketFor(unsigned long long nanoseconds) {
+        if (nanoseconds == 0) {
+            return 0;
+        }
+        return 64 - __builtin_clzll(nanoseconds);
+    }
+
+    // Returns an upper bound on the given percentile, never more than the
+    // largest recorded value. The percentile is the sample at the nearest
+    // rank, ceil(count * percent / 100), counted in integers so that 99% of
+    // 100 samples is exactly the 99th.
+    unsigned long long percentile(const TimerStats &stats, int percent) {
+        unsigned long long target = (stats.count * percent + 99) / 100;
+        if (target < 1) {
+            target = 1;
+        }
+        unsigned long long seen = 0;
+        for (int b = 0; b < BUCKET_COUNT; b++) {
+            seen += stats.buckets[b];
+            if (seen >= target) {
+                unsigned long long bound = b == 0 ? 0 :
+                (b == 64 ? ~0ULL : (1ULL << b) - 1);
+                return bound < stats.max ? bound : stats.max;
+            }
+        }
+        return stats.max;
+    }
+}
+
+unsigned long long Stats::now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void Stats::recordTime(StatsTimerId timer, unsigned long long nanoseconds) {
+    TimerStats &stats = getThreadStats()->timers[timer];
+    stats.count++;
+    stats.total += nanoseconds;
+    if (nanoseconds > stats.max) {
+        stats.max = nanoseconds;
+    }
+    stats.buckets[bucketFor(nanoseconds)]++;
+}
+
+void Stats::count(StatsCounterId counter, unsigned long long n) {
+    getThreadStats()->counters[counter] += n;
+}
+
+/*
+ * Combine the blocks of every thread and print latency percentiles and
+ * counters. Other threads may still be recording, so the totals are only
+ * approximate while they run.
+ */
+void Stats::print(std::ostream &out) {
+    TimerStats timers[STATS_TIMER_COUNT] = {};
+    unsigned long long counters[STATS_COUNTER_COUNT] = {};
+    pthread_mutex_lock(&allThreadStatsLock);
+    for (ThreadStats *t = allThreadStats; t != NULL; t = t->next) {
+        for (int i = 0; i < STATS_TIMER_COUNT; i++) {
+            timers[i].count += t->timers[i].count;
+            timers[i].total += t->timers[i].total;
+            if (t->timers[i].max > timers[i].max) {
+                timers[i].max = t->timers[i].max;
+            }
+            for (int b = 0; b < BUCKET_COUNT; b++) {
+                timers[i].buckets[b] += t->timers[i].buckets[b];
+            }
+        }
+        for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+            counters[i] += t->counters[i];
+        }
+    }
+    pthread_mutex_unlock(&allThreadStatsLock);
+
+    // Latencies are printed in microseconds
+    out << std::left << std::setw(16) << "timer" << std::right
+    << std::setw(10) << "count" << std::setw(12) << "total(us)"
+    << std::setw(12) << "p50(us)" << std::setw(12) << "p99(us)"
+    << std::setw(12) << "max(us)" << std::endl;
+    for (int i = 0; i < STATS_TIMER_COUNT; i++) {
+        out << std::left << std::setw(16) << TIMER_NAMES[i] << std::right
+        << std::setw(10) << timers[i].count
+        << std::setw(12) << timers[i].total / 1000
+        << std::setw(12) << percentile(timers[i], 50) / 1000
+        << std::setw(12) << percentile(timers[i], 99) / 1000
+        << std::setw(12) << timers[i].max / 1000 << std::endl;
+    }
+    out << std::left << std::setw(16) << "counter" << std::right
+    << std::setw(10) << "value" << std::endl;
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+        out << std::left << std::setw(16) << COUNTER_NAMES[i] << std::right
+        << std::setw(10) << counters[i] << std::endl;
+    }
+}
+
+void Stats::dump() {
+    print(std::cerr);
+}
+
+/* Count every allocation made through operator new. */
+void *operator new(std::size_t size) {
+    Stats::count(STATS_ALLOCATIONS, 1);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == NULL) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void *p) throw() {
+    free(p);
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Stats.h
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Stats
+ * This file provides the definitions for the lightweight instrumentation used
+ * to measure the hot paths of TimeField. Everything here is compiled out
+ * unless TIMEFIELD_STATS is defined.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#ifdef TIMEFIELD_STATS
+
+#include <iostream>
+
+// Latencies which are recorded in a histogram
+enum StatsTimerId {
+    STATS_LOAD,
+    STATS_PARSE,
+    STATS_QUERY,
+    STATS_SCHEDULE,
+    STATS_SAVE,
+    STATS_IMPORT,
+    STATS_TIMER_COUNT
+};
+
+// Events which are only counted
+enum StatsCounterId {
+    STATS_ALLOCATIONS,
+    STATS_TASKS_LOADED,
+    STATS_TASKS_SAVED,
+    STATS_SLOTS_GENERATED,
+    STATS_COUNTER_COUNT
+};
+
+/*
+ * Each thread accumulates into its own block, so recording never takes a
+ * lock. Blocks are only combined when the statistics are printed.
+ */
+class Stats {
+public:
+    static unsigned long long now(); // Monotonic time in nanoseconds
+    static void recordTime(StatsTimerId timer, unsigned long long nanoseconds);
+    static void count(StatsCounterId counter, unsigned long long n);
+    static void print(std::ostream &out);
+    static void dump(); // Print to stderr, suitable for atexit()
+};
+
+/* Records the time between its construction and destruction. */
+class StatsTimer {
+private:
+    StatsTimerId timer;
+    unsigned long long start;
+
+public:
+    StatsTimer(StatsTimerId timer) : timer(timer), start(Stats::now()) {}
+    ~StatsTimer() { Stats::recordTime(timer, Stats::now() - start); }
+};
+
+#define STATS_TIMER(timer) StatsTimer statsTimer(timer)
+#define STATS_COUNT(counter, n) Stats::count(counter, n)
+
+#else
+
+#define STATS_TIMER(timer)
+#define STATS_COUNT(counter, n)
+
+#endif
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * Strings.cpp
+ * Generated by genstrings from strings.xml. Do not edit.
+ * TimeField Strings
+ * This file provides the application strings for each locale.
+ */
+
+#include <cstring>
+
+#include "Strings.h"
+
+namespace {
+    const char *const enStrings[STRING_COUNT] = {
+        "TimeField",
+        "1.0.0",
+        "Please enter a command or h for help.",
+        "Please enter the following information about your task, or press Enter to accept the default value.",
+        "Title",
+        "Notes",
+        "Interval",
+        "Duration",
+        "File",
+        "Deadline alerts are on.",
+        "Deadline alerts are off.",
+        "Imported",
+        "tasks in",
+        "seconds",
+        "tasks/s",
+        "MB/s",
+        "Line",
+        "more errors.",
+        "Invalid command.",
+        "Invalid task.",
+        "Invalid interval.",
+        "Invalid input.",
+        "Failed to read file.",
+        "Nothing to undo.",
+        "Nothing to redo.",
+        "Expected title, notes, release date, due date and duration.",
+        "Invalid date.",
+        "Invalid duration.",
+        "Missing start or end time.",
+        "Missing END line.",
+        "Stray quote. Fields with quotes must be quoted, with the quotes doubled.",
+        "Statistics are not compiled into this build.",
+        "today",
+        "prev",
+        "this",
+        "next",
+        "day",
+        "week",
+    };
+
+    struct Locale {
+        const char *name;
+        const char *const *strings;
+    };
+
+    const Locale locales[] = {
+        { "en", enStrings },
+    };
+}
+
+const char *const *getStrings(const char *locale) {
+    if (locale != NULL) {
+        for (int i = 0; i < sizeof(locales) / sizeof(Locale); i++) {
+            size_t length = strlen(locales[i].name);
+            // Match the language, ignoring any territory or encoding.
+            if (strncmp(locale, locales[i].name, length) == 0
+                && strchr("_.@", locale[length]) != NULL) {
+                return locales[i].strings;
+            }
+        }
+    }
+    return locales[0].strings;
+}
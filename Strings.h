@@ -0,0 +1,62 @@
+/*
+ * Strings.h
+ * Generated by genstrings from strings.xml. Do not edit.
+ * TimeField Strings
+ * This file provides the names of the application strings.
+ */
+
+#ifndef STRINGS_H
+#define STRINGS_H
+
+enum StringId {
+    // application values
+    STRING_APPLICATION_TITLE,
+    STRING_APPLICATION_VERSION,
+    // prompts
+    STRING_COMMAND_PROMPT,
+    STRING_NEW_TASK_PROMPT,
+    STRING_TITLE_PROMPT,
+    STRING_NOTES_PROMPT,
+    STRING_INTERVAL_PROMPT,
+    STRING_DURATION_PROMPT,
+    STRING_FILENAME_PROMPT,
+    // messages
+    STRING_ALERTS_ON,
+    STRING_ALERTS_OFF,
+    STRING_IMPORTED,
+    STRING_TASKS_IN,
+    STRING_SECONDS,
+    STRING_TASKS_PER_SECOND,
+    STRING_MEGABYTES_PER_SECOND,
+    STRING_LINE,
+    STRING_MORE_ERRORS,
+    // errors
+    STRING_INVALID_COMMAND_ERROR,
+    STRING_INVALID_TASK_ERROR,
+    STRING_INVALID_INTERVAL_ERROR,
+    STRING_INVALID_INPUT_ERROR,
+    STRING_FILE_READ_ERROR,
+    STRING_NOTHING_TO_UNDO_ERROR,
+    STRING_NOTHING_TO_REDO_ERROR,
+    STRING_FIELD_COUNT_ERROR,
+    STRING_INVALID_DATE_ERROR,
+    STRING_INVALID_DURATION_ERROR,
+    STRING_MISSING_PROPERTY_ERROR,
+    STRING_UNTERMINATED_COMPONENT_ERROR,
+    STRING_STRAY_QUOTE_ERROR,
+    STRING_STATS_DISABLED_ERROR,
+    // interval strings
+    STRING_TODAY,
+    STRING_PREV,
+    STRING_THIS,
+    STRING_NEXT,
+    STRING_DAY,
+    STRING_WEEK,
+    STRING_COUNT
+};
+
+// Return the strings for a locale such as "en" or "en_US.UTF-8", or
+// for the default locale if the given one is NULL or not compiled in.
+const char *const *getStrings(const char *locale);
+
+#endif
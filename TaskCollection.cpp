@@ -0,0 +1,301 @@
+/*
+ * TaskCollection.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Task Collection
+ * This file provides the implementation for the TaskCollection class, an
+ * immutable sorted collection of tasks.
+ */
+
+#include <algorithm>
+#include <vector>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/make_shared.hpp>
+
+#include "TaskCollection.h"
+
+namespace {
+    /* Compare two tasks by release date and then due date. */
+    int compareDates(Task *a, Task *b) {
+        if (a->getInterval()->begin() != b->getInterval()->begin()) {
+            return a->getInterval()->begin() < b->getInterval()->begin()
+            ? -1 : 1;
+        }
+        if (a->getInterval()->end() != b->getInterval()->end()) {
+            return a->getInterval()->end() < b->getInterval()->end() ? -1 : 1;
+        }
+        return 0;
+    }
+
+    /*
+     * A task in a batch being added, with its dates read once as plain
+     * numbers so that sorting the batch does not compare ptimes.
+     */
+    struct BatchEntry {
+        long long release;
+        long long due;
+        Task *task;
+
+        bool operator<(const BatchEntry &other) const {
+            return release != other.release ? release < other.release
+            : due < other.due;
+        }
+    };
+
+    long long getTicks(const boost::posix_time::ptime &time) {
+        static const boost::posix_time::ptime epoch(boost::gregorian::
+                                                    date(1970, 1, 1));
+        return (time - epoch).ticks();
+    }
+}
+
+TaskCollection::TaskCollection() {
+    count = 0;
+    nextSequence = 0;
+    changeBytes = 0;
+}
+
+/* Return a collection with the task added after any with the same dates. */
+TaskCollection TaskCollection::insert(Task *task) const {
+    TaskCollection result(*this);
+    {
+        boost::shared_ptr<Node> node = boost::make_shared<Node>();
+        node->task.reset(task);
+        node->sequence = nextSequence;
+        node->priority = priorityFor(nextSequence);
+        NodePtr before, after;
+        split(root, node.get(), before, after);
+        result.root = join(join(before, node), after);
+    }
+    result.count = count + 1;
+    result.nextSequence = nextSequence + 1;
+    result.changeBytes = countUnshared(result.root) * sizeof(Node)
+    + taskBytes(task);
+    return result;
+}
+
+/*
+ * Return a collection with all of the tasks added. The batch is built into a
+ * tree of its own in one pass and then combined with the existing tree,
+ * which copies only the nodes whose children change.
+ */
+TaskCollection TaskCollection::insertAll(const std::vector<Task *> &tasks)
+const {
+    if (tasks.empty()) {
+        return *this;
+    }
+    std::vector<BatchEntry> sorted(tasks.size());
+    for (int i = 0; i < tasks.size(); i++) {
+        sorted[i].release = getTicks(tasks[i]->getInterval()->begin());
+        sorted[i].due = getTicks(tasks[i]->getInterval()->end());
+        sorted[i].task = tasks[i];
+    }
+    std::stable_sort(sorted.begin(), sorted.end());
+
+    // Tasks in the batch are numbered in order, after the existing ones.
+    std::vector<boost::shared_ptr<Node> > nodes;
+    nodes.reserve(sorted.size());
+    unsigned long long bytes = 0;
+    for (int i = 0; i < sorted.size(); i++) {
+        boost::shared_ptr<Node> node = boost::make_shared<Node>();
+        node->task.reset(sorted[i].task);
+        node->sequence = nextSequence + i;
+        node->priority = priorityFor(node->sequence);
+        nodes.push_back(node);
+        bytes += taskBytes(sorted[i].task);
+    }
+
+    TaskCollection result(*this);
+    result.root = unite(root, buildTree(nodes));
+    nodes.clear();
+    result.count = count + sorted.size();
+    result.nextSequence = nextSequence + sorted.size();
+    result.changeBytes = countUnshared(result.root) * sizeof(Node) + bytes;
+    return result;
+}
+
+/* Return a collection without the given task. */
+TaskCollection TaskCollection::erase(Task *task) const {
+    bool found = false;
+    TaskCollection result(*this);
+    result.root = remove(root, task, found);
+    if (found) {
+        result.count = count - 1;
+    }
+    result.changeBytes = countUnshared(result.root) * sizeof(Node);
+    return result;
+}
+
+/* Append the tasks to a vector in order. */
+void TaskCollection::getTasks(std::vector<Task *> &tasks) const {
+    tasks.reserve(tasks.size() + count);
+    collect(root.get(), tasks);
+}
+
+/*
+ * Build a tree from nodes which are already in order, using a stack to find
+ * each node's place in O(n) overall.
+ */
+TaskCollection::NodePtr TaskCollection::
+buildTree(const std::vector<boost::shared_ptr<Node> > &nodes) {
+    std::vector<int> stack; // Indexes of the nodes on the right spine
+    for (int i = 0; i < nodes.size(); i++) {
+        // Nodes with lower priority than the new one become its left
+        // subtree.
+        int last = -1;
+        while (!stack.empty()
+               && nodes[stack.back()]->priority < nodes[i]->priority) {
+            last = stack.back();
+            stack.pop_back();
+        }
+        if (last >= 0) {
+            nodes[i]->left = nodes[last];
+        }
+        if (!stack.empty()) {
+            nodes[stack.back()]->right = nodes[i];
+        }
+        stack.push_back(i);
+    }
+    if (stack.empty()) {
+        return NodePtr();
+    }
+    return nodes[stack.front()];
+}
+
+/* Whether a node belongs before another, by dates and then sequence. */
+bool TaskCollection::comesBefore(const Node *a, const Node *b) {
+    int comparison = compareDates(a->task.get(), b->task.get());
+    return comparison != 0 ? comparison < 0 : a->sequence < b->sequence;
+}
+
+/* Spread the sequence numbers into pseudo-random heap priorities. */
+unsigned int TaskCollection::priorityFor(unsigned long long sequence) {
+    sequence ^= sequence >> 33;
+    sequence *= 0xff51afd7ed558ccdULL;
+    sequence ^= sequence >> 33;
+    sequence *= 0xc4ceb9fe1a85ec53ULL;
+    sequence ^= sequence >> 33;
+    return (unsigned int)sequence;
+}
+
+TaskCollection::NodePtr TaskCollection::copyNode(const Node *node,
+                                                 NodePtr left, NodePtr right) {
+    boost::shared_ptr<Node> copy = boost::make_shared<Node>(*node);
+    copy->left = left;
+    copy->right = right;
+    return copy;
+}
+
+/*
+ * Split a tree into the nodes which come before a key node and the nodes
+ * which come after it, copying only the nodes along the path.
+ */
+void TaskCollection::split(NodePtr node, const Node *key, NodePtr &before,
+                           NodePtr &after) {
+    if (!node) {
+        before.reset();
+        after.reset();
+    }
+    else if (comesBefore(node.get(), key)) {
+        NodePtr rightBefore;
+        split(node->right, key, rightBefore, after);
+        before = copyNode(node.get(), node->left, rightBefore);
+    }
+    else {
+        NodePtr leftAfter;
+        split(node->left, key, before, leftAfter);
+        after = copyNode(node.get(), leftAfter, node->right);
+    }
+}
+
+/* Join two trees where every node of the first comes before the second. */
+TaskCollection::NodePtr TaskCollection::join(NodePtr before, NodePtr after) {
+    if (!before) {
+        return after;
+    }
+    if (!after) {
+        return before;
+    }
+    if (before->priority > after->priority) {
+        return copyNode(before.get(), before->left,
+                        join(before->right, after));
+    }
+    return copyNode(after.get(), join(before, after->left), after->right);
+}
+
+/*
+ * Combine two trees with no nodes in common. The root with the higher
+ * priority splits the other tree, and each half is combined with one of its
+ * subtrees, so a subtree is only copied if nodes are added inside it.
+ */
+TaskCollection::NodePtr TaskCollection::unite(NodePtr a, NodePtr b) {
+    if (!a) {
+        return b;
+    }
+    if (!b) {
+        return a;
+    }
+    if (a->priority < b->priority) {
+        std::swap(a, b);
+    }
+    NodePtr before, after;
+    split(b, a.get(), before, after);
+    NodePtr left = unite(a->left, before);
+    NodePtr right = unite(a->right, after);
+    return copyNode(a.get(), left, right);
+}
+
+/*
+ * Remove a task from a tree. Only tasks with the same dates need to be
+ * searched, and only the path to the task is copied.
+ */
+TaskCollection::NodePtr TaskCollection::remove(NodePtr node, Task *task,
+                                               bool &found) {
+    if (!node) {
+        return node;
+    }
+    if (node->task.get() == task) {
+        found = true;
+        return join(node->left, node->right);
+    }
+    int comparison = compareDates(node->task.get(), task);
+    if (comparison >= 0) {
+        NodePtr left = remove(node->left, task, found);
+        if (found) {
+            return copyNode(node.get(), left, node->right);
+        }
+    }
+    if (comparison <= 0) {
+        NodePtr right = remove(node->right, task, found);
+        if (found) {
+            return copyNode(node.get(), node->left, right);
+        }
+    }
+    return node;
+}
+
+void TaskCollection::collect(const Node *node, std::vector<Task *> &tasks) {
+    while (node != NULL) {
+        collect(node->left.get(), tasks);
+        tasks.push_back(node->task.get());
+        node = node->right.get();
+    }
+}
+
+/*
+ * Count the nodes of a new version which no other version shares. A shared
+ * node has more than one reference, and everything below it is shared too.
+ */
+unsigned long long TaskCollection::countUnshared(const NodePtr &node) {
+    if (!node || node.use_count() > 1) {
+        return 0;
+    }
+    return 1 + countUnshared(node->left) + countUnshared(node->right);
+}
+
+/* Approximate memory held by a task and its strings. */
+unsigned long long TaskCollection::taskBytes(Task *task) {
+    return sizeof(Task) + sizeof(boost::posix_time::time_period)
+    + sizeof(boost::posix_time::time_duration) + task->getTitle().size()
+    + task->getNotes().size();
+}
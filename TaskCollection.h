@@ -0,0 +1,72 @@
+/*
+ * TaskCollection.h
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Task Collection
+ * This file provides the definitions for the TaskCollection class, an
+ * immutable sorted collection of tasks.
+ */
+
+#ifndef TASK_COLLECTION_H
+#define TASK_COLLECTION_H
+
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+#include "Task.h"
+
+/*
+ * A persistent treap of tasks ordered by release date, then due date, then
+ * the order they were added. Collections are never modified; adding or
+ * removing a task returns a new collection which shares all but O(log n)
+ * nodes with the old one. Copying a collection is O(1), so old versions can
+ * be kept for undo or handed to another thread. Tasks are owned by the
+ * collections and deleted when no version refers to them.
+ */
+class TaskCollection {
+private:
+    struct Node;
+    typedef boost::shared_ptr<const Node> NodePtr;
+    struct Node {
+        boost::shared_ptr<Task> task;
+        unsigned long long sequence; // Orders tasks with the same dates
+        unsigned int priority;
+        NodePtr left;
+        NodePtr right;
+    };
+
+    NodePtr root;
+    unsigned long long count;
+    unsigned long long nextSequence;
+    unsigned long long changeBytes;
+
+    static bool comesBefore(const Node *a, const Node *b);
+    static unsigned int priorityFor(unsigned long long sequence);
+    static NodePtr copyNode(const Node *node, NodePtr left, NodePtr right);
+    static void split(NodePtr node, const Node *key, NodePtr &before,
+                      NodePtr &after);
+    static NodePtr join(NodePtr before, NodePtr after);
+    static NodePtr unite(NodePtr a, NodePtr b);
+    static NodePtr remove(NodePtr node, Task *task, bool &found);
+    static unsigned long long countUnshared(const NodePtr &node);
+    static void collect(const Node *node, std::vector<Task *> &tasks);
+    static unsigned long long taskBytes(Task *task);
+    static NodePtr buildTree(const std::vector<boost::shared_ptr<Node> >
+                             &nodes);
+
+public:
+    TaskCollection();
+    TaskCollection insert(Task *task) const;
+    TaskCollection insertAll(const std::vector<Task *> &tasks) const;
+    TaskCollection erase(Task *task) const;
+    void getTasks(std::vector<Task *> &tasks) const;
+    unsigned long long size() const { return count; }
+    // Approximate memory used by this version and not shared with the one
+    // it was made from.
+    unsigned long long getChangeBytes() const { return changeBytes; }
+    bool isSameAs(const TaskCollection &other) const {
+        return root == other.root;
+    }
+};
+
+#endif
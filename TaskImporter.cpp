@@ -0,0 +1,786 @@
+/*
+ * TaskImporter.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Task Importer
+ * This file provides the implementation for the TaskImporter class which
+ * reads tasks in bulk from CSV and iCalendar files.
+ */
+
+#include <string>
+#include <algorithm> // for min
+#include <vector>
+#include <cstring> // for memchr
+#include <cctype>
+#include <strings.h> // for strncasecmp
+#include <exception>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/date_time/c_local_time_adjustor.hpp> // for UTC times
+#include <boost/algorithm/string.hpp>
+#include <boost/thread/thread.hpp>
+
+// for mapping the file into memory
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "TaskImporter.h"
+#include "Stats.h"
+
+namespace {
+    // A piece of the file which is parsed by one thread. Line numbers in
+    // errors are relative to the start of the chunk until the chunks are
+    // merged.
+    struct ImportChunk {
+        const char *begin;
+        const char *end;
+        bool first; // Whether the chunk is at the start of the file
+        int lines;
+        std::vector<Task *> tasks;
+        std::vector<ImportError> errors;
+    };
+
+    const char *MONTH_NAMES[] = {
+        "jan", "feb", "mar", "apr", "may", "jun",
+        "jul", "aug", "sep", "oct", "nov", "dec"
+    };
+
+    // Longest duration accepted, the same as HH:MM with six digits of hours
+    const long long MAX_DURATION_SECONDS = 999999LL * 3600;
+
+    const char *lineEnd(const char *p, const char *end) {
+        const char *newline = (const char *)memchr(p, '\n', end - p);
+        return newline != NULL ? newline : end;
+    }
+
+    // Where a position in a CSV file is relative to the quoted fields
+    enum QuoteState {
+        UNQUOTED,
+        QUOTED,
+        ESCAPED, // On the first quote of a doubled quote in a quoted field
+        QUOTE_STATE_COUNT
+    };
+
+    /*
+     * Return the state after the quote at p, where begin is the start of a
+     * row and end is the end of the input. A quote only opens a field at the
+     * start of the field, and a quoted field only contains doubled quotes.
+     * Any other quote in a quoted field closes it, so that a stray quote
+     * cannot swallow the rows after it; splitRow reports the row instead.
+     */
+    QuoteState nextQuoteState(const char *p, const char *begin,
+                              const char *end, QuoteState state) {
+        switch (state) {
+            case UNQUOTED:
+                return p == begin || p[-1] == ',' || p[-1] == '\n'
+                ? QUOTED : UNQUOTED;
+            case QUOTED:
+                return p + 1 < end && p[1] == '"' ? ESCAPED : UNQUOTED;
+            default:
+                return QUOTED;
+        }
+    }
+
+    /*
+     * Find the end of the CSV row which continues from p, where a quoted
+     * field may contain line breaks. state is the quote state at p, begin is
+     * the start of a row at or before p, and the line breaks inside the row
+     * are counted.
+     */
+    const char *rowEnd(const char *p, const char *begin, const char *end,
+                       QuoteState state, int &newlines) {
+        newlines = 0;
+        if (state == UNQUOTED) {
+            // Most rows have no quotes, so try the first line break first.
+            const char *newline = lineEnd(p, end);
+            if (memchr(p, '"', newline - p) == NULL) {
+                return newline;
+            }
+        }
+        for (; p < end; p++) {
+            if (*p == '"') {
+                state = nextQuoteState(p, begin, end, state);
+            }
+            else if (*p == '\n') {
+                if (state == UNQUOTED) {
+                    return p;
+                }
+                newlines++;
+            }
+        }
+        return end;
+    }
+
+    void addError(ImportChunk *chunk, int line, ImportError::Code code) {
+        ImportError error;
+        error.line = line;
+        error.code = code;
+        chunk->errors.push_back(error);
+    }
+
+    /* Read a number with the given range of digits, advancing p. */
+    bool readNumber(const char *&p, const char *end, int minDigits,
+                    int maxDigits, int &value) {
+        int digits = 0;
+        value = 0;
+        while (p < end && *p >= '0' && *p <= '9' && digits < maxDigits) {
+            value = value * 10 + (*p - '0');
+            p++;
+            digits++;
+        }
+        return digits >= minDigits;
+    }
+
+    bool readChar(const char *&p, const char *end, char c) {
+        if (p < end && *p == c) {
+            p++;
+            return true;
+        }
+        return false;
+    }
+
+    /* Build a ptime, checking the fields first so nothing is thrown. */
+    bool makeDateTime(int year, int month, int day, int hour, int minute,
+                      int second, boost::posix_time::ptime &result) {
+        if (year < 1400 || year > 9999 || month < 1 || month > 12 || day < 1
+            || day > boost::gregorian::gregorian_calendar::
+            end_of_month_day(year, month)
+            || hour > 23 || minute > 59 || second > 59) {
+            return false;
+        }
+        result = boost::posix_time::
+        ptime(boost::gregorian::date(year, month, day),
+              boost::posix_time::time_duration(hour, minute, second));
+        return true;
+    }
+
+    /*
+     * Parse YYYY-MM-DD [HH:MM[:SS]]. The month may also be a name, as in
+     * tasks.xml, and the date and time may be separated by a T.
+     */
+    bool parseDateTime(const std::string &text,
+                       boost::posix_time::ptime &result) {
+        std::string trimmed = boost::algorithm::trim_copy(text);
+        const char *p = trimmed.c_str();
+        const char *end = p + trimmed.size();
+        int year, month = 0, day, hour = 0, minute = 0, second = 0;
+        if (!readNumber(p, end, 4, 4, year) || !readChar(p, end, '-')) {
+            return false;
+        }
+        if (end - p >= 3 && isalpha(*p)) {
+            for (int i = 0; i < 12; i++) {
+                if (strncasecmp(p, MONTH_NAMES[i], 3) == 0) {
+                    month = i + 1;
+                }
+            }
+            p += 3;
+        }
+        else if (!readNumber(p, end, 1, 2, month)) {
+            return false;
+        }
+        if (!readChar(p, end, '-') || !readNumber(p, end, 1, 2, day)) {
+            return false;
+        }
+        if (p < end) {
+            if (!readChar(p, end, ' ') && !readChar(p, end, 'T')) {
+                return false;
+            }
+            if (!readNumber(p, end, 1, 2, hour) || !readChar(p, end, ':')
+                || !readNumber(p, end, 2, 2, minute)) {
+                return false;
+            }
+            if (readChar(p, end, ':') && !readNumber(p, end, 2, 2, second)) {
+                return false;
+            }
+        }
+        return p == end
+        && makeDateTime(year, month, day, hour, minute, second, result);
+    }
+
+    /* Parse HH:MM[:SS], where the hours may be more than 24. */
+    bool parseDuration(const std::string &text,
+                       boost::posix_time::time_duration &result) {
+        std::string trimmed = boost::algorithm::trim_copy(text);
+        const char *p = trimmed.c_str();
+        const char *end = p + trimmed.size();
+        int hours, minutes, seconds = 0;
+        if (!readNumber(p, end, 1, 6, hours) || !readChar(p, end, ':')
+            || !readNumber(p, end, 2, 2, minutes) || minutes > 59) {
+            return false;
+        }
+        if (readChar(p, end, ':')
+            && (!readNumber(p, end, 2, 2, seconds) || seconds > 59)) {
+            return false;
+        }
+        result = boost::posix_time::time_duration(hours, minutes, seconds);
+        return p == end;
+    }
+
+    /*
+     * Parse an iCalendar DATE or DATE-TIME, converting UTC to local time.
+     * TZID parameters are not read, so other times are taken as local.
+     */
+    bool parseCalendarDateTime(const std::string &text,
+                               boost::posix_time::ptime &result) {
+        const char *p = text.c_str();
+        const char *end = p + text.size();
+        int year, month, day, hour = 0, minute = 0, second = 0;
+        if (!readNumber(p, end, 4, 4, year)
+            || !readNumber(p, end, 2, 2, month)
+            || !readNumber(p, end, 2, 2, day)) {
+            return false;
+        }
+        if (readChar(p, end, 'T')
+            && (!readNumber(p, end, 2, 2, hour)
+                || !readNumber(p, end, 2, 2, minute)
+                || !readNumber(p, end, 2, 2, second))) {
+            return false;
+        }
+        bool utc = readChar(p, end, 'Z');
+        if (p != end || !makeDateTime(year, month, day, hour, minute, second,
+                                      result)) {
+            return false;
+        }
+        if (utc) {
+            try {
+                result = boost::date_time::
+                c_local_adjustor<boost::posix_time::ptime>::
+                utc_to_local(result);
+            }
+            catch (...) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /* Parse an iCalendar DURATION such as PT1H30M, P2D or P1W. */
+    bool parseCalendarDuration(const std::string &text,
+                               boost::posix_time::time_duration &result) {
+        const char *p = text.c_str();
+        const char *end = p + text.size();
+        readChar(p, end, '+');
+        if (!readChar(p, end, 'P')) {
+            return false;
+        }
+        long long total = 0; // Seconds
+        bool inTime = false;
+        bool any = false;
+        while (p < end) {
+            if (!inTime && readChar(p, end, 'T')) {
+                inTime = true;
+                continue;
+            }
+            int value;
+            if (!readNumber(p, end, 1, 9, value) || p == end) {
+                return false;
+            }
+            char unit = *p++;
+            long long unitSeconds;
+            if (!inTime && unit == 'W') {
+                unitSeconds = 7 * 24 * 3600;
+            }
+            else if (!inTime && unit == 'D') {
+                unitSeconds = 24 * 3600;
+            }
+            else if (inTime && unit == 'H') {
+                unitSeconds = 3600;
+            }
+            else if (inTime && unit == 'M') {
+                unitSeconds = 60;
+            }
+            else if (inTime && unit == 'S') {
+                unitSeconds = 1;
+            }
+            else {
+                return false;
+            }
+            // Nine digits of weeks still fit in a long long, so the total
+            // can be checked before it reaches the time_duration.
+            total += value * unitSeconds;
+            if (total > MAX_DURATION_SECONDS) {
+                return false;
+            }
+            any = true;
+        }
+        result = boost::posix_time::hours((long)(total / 3600))
+        + boost::posix_time::seconds((long)(total % 3600));
+        return any;
+    }
+
+    /* Undo the backslash escapes of an iCalendar TEXT value. */
+    std::string unescapeText(const std::string &text) {
+        std::string result;
+        result.reserve(text.size());
+        for (std::string::size_type i = 0; i < text.size(); i++) {
+            if (text[i] == '\\' && i + 1 < text.size()) {
+                i++;
+                result += (text[i] == 'n' || text[i] == 'N') ? '\n' : text[i];
+            }
+            else {
+                result += text[i];
+            }
+        }
+        return result;
+    }
+
+    void addTask(ImportChunk *chunk, int line, const std::string &title,
+                 const std::string &notes, boost::posix_time::ptime release,
+                 boost::posix_time::ptime due,
+                 boost::posix_time::time_duration duration) {
+        if (due < release) {
+            addError(chunk, line, ImportError::INVALID_INTERVAL);
+            return;
+        }
+        if (duration.is_negative()) {
+            addError(chunk, line, ImportError::INVALID_DURATION);
+            return;
+        }
+        chunk->tasks.push_back(new Task(title, notes, new boost::posix_time::
+                                        time_period(release, due),
+                                        new boost::posix_time::
+                                        time_duration(duration), NULL));
+    }
+
+    /*
+     * Split a CSV row into fields, reusing the strings from the previous
+     * row. Quoted fields may contain commas, doubled quotes and line
+     * breaks. Returns false if the row has a quote anywhere else.
+     */
+    bool splitRow(const char *p, const char *end,
+                  std::vector<std::string> &fields, int &count) {
+        count = 0;
+        while (true) {
+            if (count == fields.size()) {
+                fields.push_back(std::string());
+            }
+            std::string &field = fields[count++];
+            field.clear();
+            if (p < end && *p == '"') {
+                p++;
+                while (true) {
+                    if (p >= end) {
+                        return false; // The quote is never closed
+                    }
+                    if (*p == '"') {
+                        if (p + 1 < end && p[1] == '"') {
+                            field += '"';
+                            p += 2;
+                            continue;
+                        }
+                        p++;
+                        break;
+                    }
+                    if (*p == '\r' && p + 1 < end && p[1] == '\n') {
+                        p++; // Keep only the \n of a CRLF line break
+                    }
+                    field += *p++;
+                }
+                if (p < end && *p != ',') {
+                    return false;
+                }
+            }
+            else {
+                const char *comma = (const char *)memchr(p, ',', end - p);
+                if (comma == NULL) {
+                    comma = end;
+                }
+                if (memchr(p, '"', comma - p) != NULL) {
+                    return false;
+                }
+                field.assign(p, comma);
+                p = comma;
+            }
+            if (p >= end) {
+                return true;
+            }
+            p++; // Skip the comma
+        }
+    }
+
+    void parseCsvChunk(ImportChunk *chunk) {
+        std::vector<std::string> fields;
+        boost::posix_time::ptime release, due;
+        boost::posix_time::time_duration duration;
+        chunk->lines = 0;
+        for (const char *p = chunk->begin; p < chunk->end;) {
+            int newlines;
+            const char *end = rowEnd(p, chunk->begin, chunk->end, UNQUOTED,
+                                     newlines);
+            const char *next = end < chunk->end ? end + 1 : end;
+            int line = chunk->lines + 1; // Errors refer to the row's first line
+            chunk->lines += 1 + newlines;
+            if (end > p && end[-1] == '\r') {
+                end--;
+            }
+            if (end == p) {
+                p = next;
+                continue;
+            }
+            int count;
+            bool valid = splitRow(p, end, fields, count);
+            p = next;
+            // Skip the header row
+            if (chunk->first && line == 1
+                && boost::algorithm::iequals(fields[0], "title")) {
+                continue;
+            }
+            if (!valid) {
+                addError(chunk, line, ImportError::STRAY_QUOTE);
+            }
+            else if (count != 5) {
+                addError(chunk, line, ImportError::FIELD_COUNT);
+            }
+            else if (!parseDateTime(fields[2], release)
+                     || !parseDateTime(fields[3], due)) {
+                addError(chunk, line, ImportError::INVALID_DATE);
+            }
+            else if (!parseDuration(fields[4], duration)) {
+                addError(chunk, line, ImportError::INVALID_DURATION);
+            }
+            else {
+                addTask(chunk, line, fields[0], fields[1], release, due,
+                        duration);
+            }
+        }
+    }
+
+    /* Whether a line begins a component which becomes a task. */
+    bool isTaskBegin(const char *p, const char *end) {
+        return (end - p >= 12 && strncmp(p, "BEGIN:VEVENT", 12) == 0)
+        || (end - p >= 11 && strncmp(p, "BEGIN:VTODO", 11) == 0);
+    }
+
+    void parseIcsChunk(ImportChunk *chunk) {
+        std::string line, name, value;
+        std::string title, notes;
+        boost::posix_time::ptime start, end, due, created, stamp;
+        boost::posix_time::time_duration duration;
+        bool hasStart = false, hasEnd = false, hasDue = false;
+        bool hasCreated = false, hasStamp = false;
+        bool hasDuration = false, invalid = false;
+        bool startDate = false; // Whether DTSTART is a DATE without a time
+        bool todo = false; // Whether the component is a VTODO
+        int componentLine = 0; // 0 outside of a task component
+        int depth = 0; // Nesting of other components, such as VALARM
+        chunk->lines = 0;
+        const char *p = chunk->begin;
+        while (p < chunk->end) {
+            // Unfold the next logical line; continuation lines start with a
+            // space or tab.
+            int lineNumber = chunk->lines + 1;
+            line.clear();
+            bool continuation = false;
+            do {
+                const char *lineStart = continuation ? p + 1 : p;
+                const char *e = lineEnd(p, chunk->end);
+                p = e < chunk->end ? e + 1 : e;
+                chunk->lines++;
+                if (e > lineStart && e[-1] == '\r') {
+                    e--;
+                }
+                line.append(lineStart, e);
+                continuation = true;
+            } while (p < chunk->end && (*p == ' ' || *p == '\t'));
+
+            if (line.compare(0, 6, "BEGIN:") == 0) {
+                if (componentLine != 0) {
+                    depth++;
+                    continue;
+                }
+                if (isTaskBegin(line.data(), line.data() + line.size())) {
+                    componentLine = lineNumber;
+                    title.clear();
+                    notes.clear();
+                    hasStart = hasEnd = hasDue = hasDuration = false;
+                    startDate = false;
+                    hasCreated = hasStamp = false;
+                    invalid = false;
+                    todo = line.compare(0, 11, "BEGIN:VTODO") == 0;
+                }
+                continue;
+            }
+            if (componentLine == 0) {
+                continue;
+            }
+            if (line.compare(0, 4, "END:") == 0) {
+                if (depth > 0) {
+                    depth--;
+                    continue;
+                }
+                // The due date comes from DUE, DTEND, or DTSTART + DURATION.
+                // Invalid properties have already been reported.
+                if (!todo && startDate && !hasEnd && !hasDuration) {
+                    // An all-day event without an end lasts one day.
+                    end = start + boost::gregorian::days(1);
+                    hasEnd = true;
+                }
+                if (!invalid && todo && !hasStart && (hasDue || hasEnd)) {
+                    // Most to-do items only have a due date. They are
+                    // released when they were created, but no later than
+                    // they are due, and take no time unless they say so.
+                    boost::posix_time::ptime taskDue = hasDue ? due : end;
+                    boost::posix_time::ptime release =
+                    hasCreated ? created : hasStamp ? stamp
+                    : boost::posix_time::ptime(boost::posix_time::
+                                               min_date_time);
+                    addTask(chunk, componentLine, title, notes,
+                            std::min(release, taskDue), taskDue,
+                            hasDuration ? duration
+                            : boost::posix_time::time_duration(0, 0, 0));
+                }
+                else if (!invalid && (!hasStart
+                                      || !(hasDue || hasEnd || hasDuration))) {
+                    addError(chunk, componentLine,
+                             ImportError::MISSING_PROPERTY);
+                }
+                else if (!invalid) {
+                    boost::posix_time::ptime taskDue =
+                    hasDue ? due : hasEnd ? end : start + duration;
+                    addTask(chunk, componentLine, title, notes, start,
+                            taskDue, hasDuration ? duration : taskDue - start);
+                }
+                componentLine = 0;
+                continue;
+            }
+            if (depth > 0) {
+                continue;
+            }
+
+            // Properties are NAME[;PARAM=...]:VALUE
+            std::string::size_type colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string::size_type nameEnd = line.find_first_of(";:");
+            name.assign(line, 0, nameEnd);
+            boost::algorithm::to_upper(name);
+            value.assign(line, colon + 1, std::string::npos);
+            if (name == "SUMMARY") {
+                title = unescapeText(value);
+            }
+            else if (name == "DESCRIPTION") {
+                notes = unescapeText(value);
+            }
+            else if (name == "DTSTART" || name == "DTEND" || name == "DUE") {
+                boost::posix_time::ptime date;
+                if (!parseCalendarDateTime(value, date)) {
+                    addError(chunk, lineNumber, ImportError::INVALID_DATE);
+                    invalid = true;
+                }
+                else if (name == "DTSTART") {
+                    start = date;
+                    hasStart = true;
+                    startDate = value.find('T') == std::string::npos;
+                }
+                else if (name == "DTEND") {
+                    end = date;
+                    hasEnd = true;
+                }
+                else {
+                    due = date;
+                    hasDue = true;
+                }
+            }
+            else if (name == "CREATED" || name == "DTSTAMP") {
+                // These are only used in place of a missing DTSTART, so an
+                // invalid one is ignored rather than reported.
+                boost::posix_time::ptime date;
+                if (parseCalendarDateTime(value, date)) {
+                    if (name == "CREATED") {
+                        created = date;
+                        hasCreated = true;
+                    }
+                    else {
+                        stamp = date;
+                        hasStamp = true;
+                    }
+                }
+            }
+            else if (name == "DURATION") {
+                if (!parseCalendarDuration(value, duration)) {
+                    addError(chunk, lineNumber, ImportError::INVALID_DURATION);
+                    invalid = true;
+                }
+                else {
+                    hasDuration = true;
+                }
+            }
+        }
+        if (componentLine != 0) {
+            addError(chunk, componentLine, ImportError::UNTERMINATED);
+        }
+    }
+
+    /* Parses one chunk on its own thread. */
+    struct ChunkParser {
+        ImportChunk *chunk;
+        bool calendar;
+
+        ChunkParser(ImportChunk *chunk, bool calendar)
+        : chunk(chunk), calendar(calendar) {}
+        void operator()() {
+            if (calendar) {
+                parseIcsChunk(chunk);
+            }
+            else {
+                parseCsvChunk(chunk);
+            }
+        }
+    };
+
+    /*
+     * Follows the quotes through part of a CSV file on its own thread. The
+     * state at the start of the part is not known until the parts before it
+     * are done, so the state at its end is found for every state it could
+     * start in.
+     */
+    struct QuoteScanner {
+        const char *begin; // The start of the file
+        const char *end; // The end of the file
+        const char *partBegin;
+        const char *partEnd;
+        QuoteState *exits; // The state at the end for each starting state
+
+        QuoteScanner(const char *begin, const char *end,
+                     const char *partBegin, const char *partEnd,
+                     QuoteState *exits)
+        : begin(begin), end(end), partBegin(partBegin), partEnd(partEnd),
+        exits(exits) {}
+        void operator()() {
+            for (int i = 0; i < QUOTE_STATE_COUNT; i++) {
+                QuoteState state = (QuoteState)i;
+                for (const char *p = partBegin;
+                     (p = (const char *)memchr(p, '"', partEnd - p)) != NULL;
+                     p++) {
+                    state = nextQuoteState(p, begin, end, state);
+                }
+                exits[i] = state;
+            }
+        }
+    };
+
+    /*
+     * Find where the chunk after the given position should start: the next
+     * row of a CSV file, or the next task component of a calendar. state
+     * says whether the position is inside a quoted CSV field, so that a line
+     * break inside the field is not taken for the end of the row.
+     */
+    const char *findChunkStart(const char *p, const char *begin,
+                               const char *end, bool calendar,
+                               QuoteState state) {
+        if (p <= begin) {
+            return begin;
+        }
+        if (!calendar) {
+            int newlines;
+            p = rowEnd(p, begin, end, state, newlines);
+            return p < end ? p + 1 : end;
+        }
+        // Start from the beginning of a line.
+        p = lineEnd(p - 1, end);
+        while (p < end) {
+            p++;
+            if (isTaskBegin(p, end)) {
+                return p;
+            }
+            p = lineEnd(p, end);
+        }
+        return end;
+    }
+}
+
+TaskImporter::TaskImporter(std::string filename) {
+    TaskImporter::filename = filename;
+    bytes = 0;
+}
+
+/* Read the whole file. Throws std::exception if it cannot be read. */
+void TaskImporter::import() {
+    STATS_TIMER(STATS_IMPORT);
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::exception();
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        throw std::exception();
+    }
+    bytes = status.st_size;
+    if (bytes == 0) {
+        close(fd);
+        return;
+    }
+    void *mapping = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::exception();
+    }
+    madvise(mapping, bytes, MADV_SEQUENTIAL);
+    const char *begin = (const char *)mapping;
+    const char *end = begin + bytes;
+    bool calendar = boost::algorithm::iends_with(filename, ".ics");
+
+    // Split the file into one chunk per core.
+    int threadCount = boost::thread::hardware_concurrency();
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    // A CSV chunk must not start inside a quoted field, which may contain
+    // line breaks. Following the quotes up to each split point tells
+    // whether it is inside one.
+    std::vector<QuoteState> exits(threadCount * QUOTE_STATE_COUNT, UNQUOTED);
+    if (!calendar && threadCount > 1) {
+        boost::thread_group scanners;
+        for (int i = 0; i < threadCount - 1; i++) {
+            scanners.create_thread(QuoteScanner(begin, end, begin + bytes * i
+                                                / threadCount, begin + bytes
+                                                * (i + 1) / threadCount,
+                                                &exits[i * QUOTE_STATE_COUNT]));
+        }
+        scanners.join_all();
+    }
+    std::vector<ImportChunk> chunks(threadCount);
+    const char *chunkStart = begin;
+    QuoteState state = UNQUOTED;
+    for (int i = 0; i < threadCount; i++) {
+        state = exits[i * QUOTE_STATE_COUNT + state];
+        const char *chunkEnd = i == threadCount - 1 ? end :
+        findChunkStart(begin + bytes * (i + 1) / threadCount, begin, end,
+                       calendar, state);
+        if (chunkEnd < chunkStart) {
+            chunkEnd = chunkStart;
+        }
+        chunks[i].begin = chunkStart;
+        chunks[i].end = chunkEnd;
+        chunks[i].first = i == 0;
+        chunks[i].lines = 0;
+        chunkStart = chunkEnd;
+    }
+
+    boost::thread_group threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.create_thread(ChunkParser(&chunks[i], calendar));
+    }
+    threads.join_all();
+    munmap(mapping, bytes);
+
+    // Merge the chunks in order, making the line numbers absolute.
+    std::vector<Task *>::size_type taskCount = 0;
+    for (int i = 0; i < threadCount; i++) {
+        taskCount += chunks[i].tasks.size();
+    }
+    tasks.reserve(taskCount);
+    int lineOffset = 0;
+    for (int i = 0; i < threadCount; i++) {
+        tasks.insert(tasks.end(), chunks[i].tasks.begin(),
+                     chunks[i].tasks.end());
+        for (int j = 0; j < chunks[i].errors.size(); j++) {
+            chunks[i].errors[j].line += lineOffset;
+            errors.push_back(chunks[i].errors[j]);
+        }
+        lineOffset += chunks[i].lines;
+    }
+}
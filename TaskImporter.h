@@ -0,0 +1,63 @@
+/*
+ * TaskImporter.h
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Task Importer
+ * This file provides the definitions for the TaskImporter class which reads
+ * tasks in bulk from CSV and iCalendar files.
+ */
+
+#ifndef TASK_IMPORTER_H
+#define TASK_IMPORTER_H
+
+#include <string>
+#include <vector>
+
+#include "Task.h"
+
+/* A line of the input which could not be imported, and why. */
+struct ImportError {
+    enum Code {
+        FIELD_COUNT, // A CSV row without exactly five fields
+        INVALID_DATE,
+        INVALID_DURATION,
+        INVALID_INTERVAL, // The due date is before the release date
+        MISSING_PROPERTY, // A calendar component without a start or end
+        UNTERMINATED, // A calendar component without an END line
+        STRAY_QUOTE // A CSV quote which does not open or close a field
+    };
+    int line;
+    Code code;
+};
+
+/*
+ * Files ending in .ics are read as iCalendar, where each VEVENT or VTODO is
+ * a task. A VTODO with only a due date is released when it was created,
+ * and an all-day VEVENT without an end lasts one day. Times with a TZID
+ * parameter are read as local time rather than in that time zone.
+ * Anything else is read as CSV with the columns title, notes, release date,
+ * due date and duration, and an optional header row. Quoted fields may span
+ * lines, and a quote may only appear in a field which is quoted. Dates are
+ * YYYY-MM-DD [HH:MM[:SS]] and durations are HH:MM[:SS].
+ *
+ * The file is mapped into memory and split into one chunk per core, and the
+ * chunks are parsed in parallel. Rows with errors are skipped and reported
+ * rather than stopping the import.
+ */
+class TaskImporter {
+private:
+    std::string filename;
+    std::vector<Task *> tasks;
+    std::vector<ImportError> errors;
+    unsigned long long bytes;
+
+public:
+    TaskImporter(std::string filename);
+    void import();
+    // The caller takes ownership of the imported tasks.
+    std::vector<Task *> &getTasks() { return tasks; }
+    std::vector<ImportError> &getErrors() { return errors; }
+    unsigned long long getBytes() { return bytes; }
+};
+
+#endif
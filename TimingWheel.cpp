@@ -0,0 +1,156 @@
+/*
+ * TimingWheel.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Timing Wheel
+ * This file provides the implementation for the TimingWheel class, a
+ * hierarchical timing wheel which keeps track of a large number of timers.
+ */
+
+#include <vector>
+
+#include "TimingWheel.h"
+
+TimingWheel::TimingWheel(unsigned long long now) {
+    current = now;
+    armedCount = 0;
+    for (int level = 0; level < LEVELS; level++) {
+        levelCount[level] = 0;
+        for (int i = 0; i < SLOTS; i++) {
+            slots[level][i].prev = &slots[level][i];
+            slots[level][i].next = &slots[level][i];
+        }
+    }
+}
+
+/* Arm a timer to expire at the given tick, re-arming it if necessary. */
+void TimingWheel::arm(Timer *timer, unsigned long long expires) {
+    if (timer->isArmed()) {
+        cancel(timer);
+    }
+    timer->expires = expires;
+    place(timer);
+    armedCount++;
+}
+
+void TimingWheel::cancel(Timer *timer) {
+    if (timer->isArmed()) {
+        unlink(timer);
+        armedCount--;
+    }
+}
+
+/*
+ * Process every tick up to and including now, collecting the timers which
+ * expire. Expired timers are disarmed and may be armed again by the caller.
+ */
+void TimingWheel::advance(unsigned long long now,
+                          std::vector<Timer *> &expired) {
+    while (current <= now) {
+        // Jump over the ticks in which nothing can expire or cascade.
+        unsigned long long tick = armedCount == 0 ? now + 1 : nextTick();
+        if (tick > now) {
+            current = now + 1;
+            break;
+        }
+        current = tick;
+        int index = (int)(current & SLOT_MASK);
+        // At the start of each turn, bring the timers for the coming turn
+        // down from the next level, and so on up the wheel.
+        if (index == 0) {
+            for (int level = 1; level < LEVELS && cascade(level); level++) {}
+        }
+        Timer *head = &slots[0][index];
+        while (head->next != head) {
+            Timer *timer = head->next;
+            unlink(timer);
+            armedCount--;
+            expired.push_back(timer);
+        }
+        current++;
+    }
+}
+
+/*
+ * Returns the first tick at which a timer may expire or need to be
+ * cascaded. Nothing happens before it, so the caller can sleep until then.
+ */
+unsigned long long TimingWheel::nextTick() const {
+    unsigned long long best = ~0ULL;
+    for (int level = 0; level < LEVELS; level++) {
+        if (levelCount[level] == 0) {
+            continue;
+        }
+        // A slot on this level is only visited at the start of a turn of the
+        // level below.
+        int shift = SLOT_BITS * level;
+        unsigned long long step = 1ULL << shift;
+        unsigned long long tick = (current + step - 1) & ~(step - 1);
+        for (int i = 0; i < SLOTS && tick < best; i++, tick += step) {
+            const Timer *head = &slots[level][(tick >> shift) & SLOT_MASK];
+            if (head->next != head) {
+                best = tick;
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+/* Put a timer in the slot which covers its expiry time. */
+void TimingWheel::place(Timer *timer) {
+    unsigned long long expires = timer->expires;
+    if (expires < current) {
+        expires = current; // Already due, so expire on the next tick
+    }
+    unsigned long long delta = expires - current;
+    int level = 0;
+    while (level < LEVELS - 1
+           && delta >= 1ULL << (SLOT_BITS * (level + 1))) {
+        level++;
+    }
+    // Timers beyond the range of the wheel wait in the farthest slot of the
+    // top level and are placed again when it is cascaded.
+    unsigned long long range = 1ULL << (SLOT_BITS * LEVELS);
+    if (delta >= range) {
+        expires = current + range - 1;
+    }
+    link(level, (int)((expires >> (SLOT_BITS * level)) & SLOT_MASK), timer);
+}
+
+/*
+ * Move the timers in the current slot of a level down the wheel. Returns
+ * true if this level has also completed a turn, so the next level up must be
+ * cascaded too.
+ */
+bool TimingWheel::cascade(int level) {
+    int index = (int)((current >> (SLOT_BITS * level)) & SLOT_MASK);
+    Timer *head = &slots[level][index];
+    // Every timer here is now due within a turn of this level, so it moves
+    // to a lower level. Timers beyond the range of the wheel move to another
+    // slot of the top level.
+    while (head->next != head) {
+        Timer *timer = head->next;
+        unlink(timer);
+        place(timer);
+    }
+    return index == 0;
+}
+
+void TimingWheel::link(int level, int index, Timer *timer) {
+    Timer *head = &slots[level][index];
+    timer->level = level;
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+    levelCount[level]++;
+}
+
+void TimingWheel::unlink(Timer *timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = NULL;
+    timer->next = NULL;
+    levelCount[timer->level]--;
+}
@@ -0,0 +1,64 @@
+/*
+ * TimingWheel.h
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField Timing Wheel
+ * This file provides the definitions for the TimingWheel class, a
+ * hierarchical timing wheel which keeps track of a large number of timers.
+ */
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <cstddef> // for NULL
+#include <vector>
+
+/*
+ * Timers are kept in doubly linked lists, one per slot, so arming and
+ * cancelling a timer take constant time. The first level has one slot per
+ * tick; each higher level has slots covering 256 times as many ticks, and
+ * its timers are cascaded down as the wheel turns. Ticks in which nothing
+ * can happen are skipped, so idle stretches cost almost nothing. The wheel
+ * does not own its timers.
+ */
+class TimingWheel {
+public:
+    class Timer {
+        friend class TimingWheel;
+    private:
+        unsigned long long expires;
+        int level;
+        Timer *prev;
+        Timer *next;
+
+    public:
+        Timer() : expires(0), level(0), prev(NULL), next(NULL) {}
+        bool isArmed() const { return next != NULL; }
+        unsigned long long getExpiry() const { return expires; }
+    };
+
+    TimingWheel(unsigned long long now);
+    void arm(Timer *timer, unsigned long long expires);
+    void cancel(Timer *timer);
+    void advance(unsigned long long now, std::vector<Timer *> &expired);
+    unsigned long long nextTick() const;
+    bool empty() const { return armedCount == 0; }
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const unsigned long long SLOT_MASK = SLOTS - 1;
+
+    Timer slots[LEVELS][SLOTS]; // List heads; an empty slot points to itself
+    unsigned long long current; // The next tick to be processed
+    unsigned long long armedCount;
+    unsigned long long levelCount[LEVELS];
+
+    void place(Timer *timer);
+    bool cascade(int level);
+    void link(int level, int index, Timer *timer);
+    void unlink(Timer *timer);
+};
+
+#endif
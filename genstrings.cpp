@@ -0,0 +1,241 @@
+/*
+ * genstrings.cpp
+ * Ryan Burgoyne
+ * 18 Oct 2026
+ * TimeField String Generator
+ * This file provides a build tool which compiles the application strings
+ * into C++ tables, so they need not be read and parsed on every launch.
+ * Usage: genstrings strings.xml [strings-LOCALE.xml ...]
+ * The first file is the default locale and defines the string names. Each
+ * file names its locale with the locale attribute of its strings element.
+ * Strings missing from a translation fall back to the default locale.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cctype> // for toupper and isprint
+#include <cstdio> // for snprintf
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/foreach.hpp>
+
+#define HEADER_FILENAME "Strings.h"
+#define SOURCE_FILENAME "Strings.cpp"
+#define DEFAULT_LOCALE "en"
+
+struct Entry {
+    std::string name;
+    std::string comment; // Section comment which comes before the entry
+};
+
+struct Catalog {
+    std::string locale;
+    std::map<std::string, std::string> values;
+};
+
+void readCatalog(const char *filename, Catalog &catalog,
+                 std::vector<Entry> *entries);
+std::string getIdentifier(const std::string &name);
+std::string getTableName(const std::string &locale);
+std::string getLiteral(const std::string &value);
+std::string trim(const std::string &text);
+
+/* Read the catalogs, then write the header and source files. */
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+        << " strings.xml [strings-LOCALE.xml ...]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Entry> entries;
+    std::vector<Catalog> catalogs(argc - 1);
+    try {
+        for (int i = 1; i < argc; i++) {
+            readCatalog(argv[i], catalogs[i - 1], i == 1 ? &entries : NULL);
+        }
+    }
+    catch (std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::ofstream header(HEADER_FILENAME);
+    header << "/*\n"
+    " * " HEADER_FILENAME "\n"
+    " * Generated by genstrings from " << argv[1] << ". Do not edit.\n"
+    " * TimeField Strings\n"
+    " * This file provides the names of the application strings.\n"
+    " */\n"
+    "\n"
+    "#ifndef STRINGS_H\n"
+    "#define STRINGS_H\n"
+    "\n"
+    "enum StringId {\n";
+    BOOST_FOREACH(Entry &entry, entries)
+    {
+        if (!entry.comment.empty()) {
+            header << "    // " << entry.comment << "\n";
+        }
+        header << "    " << getIdentifier(entry.name) << ",\n";
+    }
+    header << "    STRING_COUNT\n"
+    "};\n"
+    "\n"
+    "// Return the strings for a locale such as \"en\" or \"en_US.UTF-8\", or\n"
+    "// for the default locale if the given one is NULL or not compiled in.\n"
+    "const char *const *getStrings(const char *locale);\n"
+    "\n"
+    "#endif\n";
+
+    std::ofstream source(SOURCE_FILENAME);
+    source << "/*\n"
+    " * " SOURCE_FILENAME "\n"
+    " * Generated by genstrings from " << argv[1] << ". Do not edit.\n"
+    " * TimeField Strings\n"
+    " * This file provides the application strings for each locale.\n"
+    " */\n"
+    "\n"
+    "#include <cstring>\n"
+    "\n"
+    "#include \"" HEADER_FILENAME "\"\n"
+    "\n"
+    "namespace {\n";
+    BOOST_FOREACH(Catalog &catalog, catalogs)
+    {
+        source << "    const char *const " << getTableName(catalog.locale)
+        << "[STRING_COUNT] = {\n";
+        BOOST_FOREACH(Entry &entry, entries)
+        {
+            std::map<std::string, std::string>::iterator value =
+            catalog.values.find(entry.name);
+            if (value == catalog.values.end()) {
+                value = catalogs[0].values.find(entry.name);
+            }
+            source << "        " << getLiteral(value->second) << ",\n";
+        }
+        source << "    };\n"
+        "\n";
+    }
+    source << "    struct Locale {\n"
+    "        const char *name;\n"
+    "        const char *const *strings;\n"
+    "    };\n"
+    "\n"
+    "    const Locale locales[] = {\n";
+    BOOST_FOREACH(Catalog &catalog, catalogs)
+    {
+        source << "        { \"" << catalog.locale << "\", "
+        << getTableName(catalog.locale) << " },\n";
+    }
+    source << "    };\n"
+    "}\n"
+    "\n"
+    "const char *const *getStrings(const char *locale) {\n"
+    "    if (locale != NULL) {\n"
+    "        for (int i = 0; i < sizeof(locales) / sizeof(Locale); i++) {\n"
+    "            size_t length = strlen(locales[i].name);\n"
+    "            // Match the language, ignoring any territory or encoding.\n"
+    "            if (strncmp(locale, locales[i].name, length) == 0\n"
+    "                && strchr(\"_.@\", locale[length]) != NULL) {\n"
+    "                return locales[i].strings;\n"
+    "            }\n"
+    "        }\n"
+    "    }\n"
+    "    return locales[0].strings;\n"
+    "}\n";
+
+    if (!header || !source) {
+        std::cerr << "Failed to write " HEADER_FILENAME " and "
+        SOURCE_FILENAME "." << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Read the strings from an XML file. The order of the names and the section
+ * comments are also read from the default locale's file.
+ */
+void readCatalog(const char *filename, Catalog &catalog,
+                 std::vector<Entry> *entries) {
+    boost::property_tree::ptree pt;
+    read_xml(filename, pt);
+    boost::property_tree::ptree &root = pt.get_child("strings");
+    catalog.locale = root.get<std::string>("<xmlattr>.locale", DEFAULT_LOCALE);
+    std::string comment;
+    BOOST_FOREACH(boost::property_tree::ptree::value_type &v, root)
+    {
+        if (v.first == "<xmlcomment>") {
+            comment = trim(v.second.data());
+        }
+        else if (v.first == "string") {
+            std::string name = v.second.get<std::string>("<xmlattr>.name");
+            catalog.values[name] = v.second.data();
+            if (entries != NULL) {
+                Entry entry;
+                entry.name = name;
+                entry.comment = comment;
+                entries->push_back(entry);
+                comment.clear();
+            }
+        }
+    }
+}
+
+/* Turn a string name such as "title-prompt" into STRING_TITLE_PROMPT. */
+std::string getIdentifier(const std::string &name) {
+    std::string identifier = "STRING_";
+    for (int i = 0; i < name.size(); i++) {
+        identifier += isalnum((unsigned char)name[i])
+        ? (char)toupper((unsigned char)name[i]) : '_';
+    }
+    return identifier;
+}
+
+/* Turn a locale such as "pt-BR" into a table name such as pt_BRStrings. */
+std::string getTableName(const std::string &locale) {
+    std::string name;
+    for (int i = 0; i < locale.size(); i++) {
+        name += isalnum((unsigned char)locale[i]) ? locale[i] : '_';
+    }
+    return name + "Strings";
+}
+
+/* Quote a string as a C++ literal. */
+std::string getLiteral(const std::string &value) {
+    std::stringstream literal;
+    literal << '"';
+    for (int i = 0; i < value.size(); i++) {
+        unsigned char c = value[i];
+        // Question marks are escaped so they cannot form trigraphs.
+        if (c == '"' || c == '\\' || c == '?') {
+            literal << '\\' << c;
+        }
+        else if (isprint(c)) {
+            literal << c;
+        }
+        else {
+            // Three octal digits, so a following digit is not absorbed.
+            char escape[5];
+            snprintf(escape, sizeof(escape), "\\%03o", c);
+            literal << escape;
+        }
+    }
+    literal << '"';
+    return literal.str();
+}
+
+std::string trim(const std::string &text) {
+    std::string::size_type begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    std::string::size_type end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
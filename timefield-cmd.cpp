@@ -13,14 +13,9 @@
 #include <fstream> // for ifstream - reading the help file
 #include <string>
 #include <sstream> // for writing working interval to output
-#include <map> // for storing the application strings
 #include <exception>
 #include <vector>
-
-// for loading strings.xml
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/xml_parser.hpp>
-#include <boost/foreach.hpp>
+#include <cstdlib> // for getenv and atexit
 
 #include <boost/lexical_cast.hpp> // for converting string to integer
 #include <boost/algorithm/string.hpp> // for removing leading whitespace and
@@ -31,20 +26,31 @@
 #include <boost/date_time/gregorian/gregorian.hpp>
 
 #include "Scheduler.h" // Manages the tasks
+#include "ScheduleGenerator.h" // Computes the schedule one slot at a time
+#include "DeadlineMonitor.h" // Raises alerts for tasks in the background
+#include "TaskImporter.h" // Reads tasks from CSV and iCalendar files
+#include "Strings.h" // Application strings, generated from strings.xml
+#include "Stats.h" // Instrumentation, compiled in with -DTIMEFIELD_STATS
 #include "Task.h"
 
 #define TASKS_FILENAME "tasks.xml" // contains the persistent XML task data
-#define STRINGS_FILENAME "strings.xml" // contains application strings, 
-                                       // separated from the source code 
-                                       // to simplify localization
 #define HELP_FILENAME "help.txt" // contains help information which can be 
                                  // displayed on the command line
+#define STATS_DUMP_VARIABLE "TIMEFIELD_STATS_DUMP" // if set, statistics are
+                                                   // printed to stderr at exit
+#define ALERT_HOOK_VARIABLE "TIMEFIELD_ALERT_HOOK" // command which receives
+                                                   // alerts instead of stdout
+#define ALERT_LEAD_VARIABLE "TIMEFIELD_ALERT_LEAD" // minutes of warning before
+                                                   // a task is due
+#define DEFAULT_ALERT_LEAD 60
+#define MAX_IMPORT_ERRORS_SHOWN 20
+#define UNDO_LIMIT_VARIABLE "TIMEFIELD_UNDO_LIMIT" // megabytes of undo history,
+                                                  // or 0 for no limit
 
 std::string cwd;
-std::map<std::string,std::string> strings; // string names are mapped to actual 
-                                           // string values
+const char *const *strings; // application strings for the user's locale
+DeadlineMonitor *monitor = NULL; // NULL while alerts are off
 
-void loadStrings();
 void list(Scheduler *scheduler);
 boost::posix_time::time_period *
 parseInterval(std::string, const boost::posix_time::time_period 
@@ -55,12 +61,16 @@ boost::posix_time::ptime parseDateTime(std::string dateTimeString,
                                        int currentYear,
                                        const boost::gregorian::date today);
 void newTask(Scheduler *scheduler);
+void importTasks(Scheduler *scheduler, std::string input);
 void editTask(Scheduler *scheduler, int id);
 void deleteTask(Scheduler *scheduler, int id);
 void printTask(Scheduler *scheduler, int id);
 void spawnTask(Scheduler *scheduler, int parentId);
 void generateSchedule(Scheduler *scheduler);
+void toggleAlerts(Scheduler *scheduler);
+void showStats();
 void showHelp();
+const char *getLocale();
 std::string prompt(std::string promptText, std::string defaultVal);
 std::string buildIntervalString(boost::posix_time::time_period *interval);
 std::string getDateTimeString(boost::posix_time::ptime dateTime, 
@@ -72,28 +82,57 @@ class InvalidIntervalException : public std::exception {};
 
 /* Load application strings, then loop through the main menu */
 int main(int argc,char *argv[]) {
+#ifdef TIMEFIELD_STATS
+    if (getenv(STATS_DUMP_VARIABLE) != NULL) {
+        atexit(Stats::dump);
+    }
+#endif
     std::string pathToExe = std::string(argv[0]);
     int lastSeparator = pathToExe.find_last_of('/');
     cwd = pathToExe.substr(0, lastSeparator + 1);
-    // Create the Scheduler object which performs the task management.
-    std::stringstream tasksPath;
-    tasksPath << cwd << TASKS_FILENAME;
-    Scheduler *scheduler = new Scheduler(tasksPath.str());
+    // Create the Scheduler object which performs the task management. Task
+    // files may be given as arguments; otherwise the default file is used.
+    // The files are not read until a command needs their tasks.
+    std::vector<std::string> tasksPaths(argv + 1, argv + argc);
+    if (tasksPaths.empty()) {
+        std::stringstream tasksPath;
+        tasksPath << cwd << TASKS_FILENAME;
+        tasksPaths.push_back(tasksPath.str());
+    }
+    Scheduler *scheduler = new Scheduler(tasksPaths);
+    const char *undoLimit = getenv(UNDO_LIMIT_VARIABLE);
+    if (undoLimit != NULL) {
+        try {
+            scheduler->setHistoryLimit(boost::lexical_cast<unsigned long long>
+                                       (undoLimit) * 1024 * 1024);
+        }
+        catch (...) {}
+    }
 
-    // Load user interface strings into a map
-    loadStrings();
+    // Choose the compiled-in strings for the user's locale
+    strings = getStrings(getLocale());
     std::string input;
     
-    std::cout << strings["application-title"] << " " << 
-    strings["application-version"] << std::endl;
+    std::cout << strings[STRING_APPLICATION_TITLE] << " " << 
+    strings[STRING_APPLICATION_VERSION] << std::endl;
     // Print the command prompt.
-    std::cout << strings["command-prompt"] << std::endl;
+    std::cout << strings[STRING_COMMAND_PROMPT] << std::endl;
     while (true) {
         int id = -1; // ID -1 means no task selected.
         // Print the working interval at the head of each prompt.
         std::cout << buildIntervalString(scheduler->getWorkingInterval()) 
         << " ";
-        getline(std::cin, input);
+        // Quit at the end of the input, e.g. when commands are piped in.
+        if (!getline(std::cin, input)) {
+            std::cout << std::endl;
+            if (monitor != NULL) {
+                toggleAlerts(scheduler);
+            }
+            break;
+        }
+        if (input.empty()) {
+            continue;
+        }
         switch (input[0]) {
             case 'l': // list all tasks
                 list(scheduler);
@@ -110,6 +149,9 @@ int main(int argc,char *argv[]) {
             case 'n': // new task
                 newTask(scheduler);
                 break;
+            case 'i': // import tasks from a file
+                importTasks(scheduler, input);
+                break;
             case 'e': // edit task
                 id = getTaskId(input);
                 if (id != -1) {
@@ -134,17 +176,38 @@ int main(int argc,char *argv[]) {
                     spawnTask(scheduler, id);
                 }
                 break;
+            case 'u': // undo the last change
+                if (!scheduler->undo()) {
+                    std::cout << strings[STRING_NOTHING_TO_UNDO_ERROR]
+                    << std::endl;
+                }
+                break;
+            case 'r': // redo the last undone change
+                if (!scheduler->redo()) {
+                    std::cout << strings[STRING_NOTHING_TO_REDO_ERROR]
+                    << std::endl;
+                }
+                break;
             case 'g':
                 generateSchedule(scheduler);
                 break;
+            case 'a': // turn deadline alerts on or off
+                toggleAlerts(scheduler);
+                break;
+            case 't': // display timing statistics
+                showStats();
+                break;
             case 'h': // display help
                 showHelp();
                 break;
             case 'q': //quit
+                if (monitor != NULL) {
+                    toggleAlerts(scheduler);
+                }
                 delete scheduler;
                 return 0;
             default:
-                std::cout << strings["invalid-command-error"] << std::endl;
+                std::cout << strings[STRING_INVALID_COMMAND_ERROR] << std::endl;
                 break;
         }
     }
@@ -153,6 +216,7 @@ int main(int argc,char *argv[]) {
 
 /* List all tasks in the working interval. */
 void list(Scheduler *scheduler) {
+    STATS_TIMER(STATS_QUERY);
     std::vector<Task *> list = scheduler->getTaskList();
     for (int i = 0; i < list.size(); i++) {
         if (list[i]->getInterval()->intersects(*scheduler->getWorkingInterval())) 
@@ -180,6 +244,7 @@ boost::posix_time::time_period *parseInterval(std::string input,
     const boost::gregorian::date today(boost::gregorian::day_clock::
                                        local_day());
     
+    STATS_TIMER(STATS_PARSE);
     // These times will be set and passed as the new interval at the end of the
     // function.
     boost::posix_time::ptime begin, end;
@@ -233,26 +298,26 @@ boost::posix_time::time_period *parseInterval(std::string input,
             int splitPos = input.find(' ');
             std::string firstWord = input.substr(0, splitPos);
             std::string secondWord = input.substr(splitPos + 1);
-            if (firstWord == strings["today"]) {
+            if (firstWord == strings[STRING_TODAY]) {
                 // Set working interval to the current day
                 begin = boost::posix_time::ptime(today);
                 end = begin + oneDay;
             }
-            else if (firstWord == strings["prev"]) {
-                if (secondWord == strings["day"]) {
+            else if (firstWord == strings[STRING_PREV]) {
+                if (secondWord == strings[STRING_DAY]) {
                     begin = boost::posix_time::ptime(currentBeginDate
                                                      - boost::gregorian::days(1));
                     end = begin + oneDay;
                 }
-                else if (secondWord == strings["week"]) {
+                else if (secondWord == strings[STRING_WEEK]) {
                     begin = boost::posix_time::ptime(currentBeginDate - boost::
                                                      gregorian::days(dayOfWeek)
                                                      - boost::gregorian::weeks(1));
                     end = begin + oneWeek;
                 }
             }
-            else if (firstWord == strings["this"]) {
-                if (secondWord == strings["day"]) { // Differs from "today" because
+            else if (firstWord == strings[STRING_THIS]) {
+                if (secondWord == strings[STRING_DAY]) { // Differs from "today" because
                                                     // it refers to the first day
                                                     // of the current working
                                                     // interval, not the acutal 
@@ -260,19 +325,19 @@ boost::posix_time::time_period *parseInterval(std::string input,
                     begin = boost::posix_time::ptime(currentBeginDate);
                     end = begin + oneDay;                
                 }
-                else if (secondWord == strings["week"]) {
+                else if (secondWord == strings[STRING_WEEK]) {
                     begin = boost::posix_time::ptime(currentBeginDate - boost::
                                                      gregorian::days(dayOfWeek));
                     end = begin + oneWeek;
                 }
             }
-            else if (firstWord == strings["next"]) {
-                if (secondWord == strings["day"]) {
+            else if (firstWord == strings[STRING_NEXT]) {
+                if (secondWord == strings[STRING_DAY]) {
                     begin = boost::posix_time::ptime(currentBeginDate
                                                      + boost::gregorian::days(1));
                     end = begin + oneDay;
                 }
-                else if (secondWord == strings["week"]) {
+                else if (secondWord == strings[STRING_WEEK]) {
                     begin = boost::posix_time::ptime(currentBeginDate - boost::
                                                      gregorian::days(dayOfWeek)
                                                      + boost::gregorian::weeks(1));
@@ -297,7 +362,7 @@ boost::posix_time::time_period *parseInterval(std::string input,
         return new boost::posix_time::time_period(begin, end);
     }
     catch (std::exception &e) {
-        std::cout << strings["invalid-interval-error"] << std::endl;
+        std::cout << strings[STRING_INVALID_INTERVAL_ERROR] << std::endl;
         throw e;
     }
 }
@@ -399,13 +464,13 @@ boost::posix_time::ptime parseDateTime(std::string dateTimeString,
 /* Prompt for input, then generate a new task. */
 void newTask(Scheduler *scheduler) {
     std::string title, notes, intervalString, durationString;
-    std::cout << strings["new-task-prompt"] << std::endl;
+    std::cout << strings[STRING_NEW_TASK_PROMPT] << std::endl;
 
     try {
-        title = prompt(strings["title-prompt"], "");
-        notes = prompt(strings["notes-prompt"], "");
-        intervalString = prompt(strings["interval-prompt"], "");
-        durationString = prompt(strings["duration-prompt"], "");
+        title = prompt(strings[STRING_TITLE_PROMPT], "");
+        notes = prompt(strings[STRING_NOTES_PROMPT], "");
+        intervalString = prompt(strings[STRING_INTERVAL_PROMPT], "");
+        durationString = prompt(strings[STRING_DURATION_PROMPT], "");
         
         boost::posix_time::time_period *interval = 
         parseInterval(intervalString, scheduler->getWorkingInterval());
@@ -418,8 +483,73 @@ void newTask(Scheduler *scheduler) {
         scheduler->addTask(new Task(title, notes, interval, duration, NULL));
     }
     catch (...) {
-        std::cout << strings["invalid-input-error"] << std::endl;
+        std::cout << strings[STRING_INVALID_INPUT_ERROR] << std::endl;
+    }
+}
+
+/* Import tasks from a CSV or iCalendar file and report how long it took. */
+void importTasks(Scheduler *scheduler, std::string input) {
+    std::string filename = boost::algorithm::trim_copy(input.substr(1));
+    if (filename == "") {
+        filename = prompt(strings[STRING_FILENAME_PROMPT], "");
+    }
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::
+    local_time();
+    TaskImporter importer(filename);
+    try {
+        importer.import();
+    }
+    catch (...) {
+        std::cout << strings[STRING_FILE_READ_ERROR] << std::endl;
+        return;
+    }
+    std::vector<Task *> &tasks = importer.getTasks();
+    scheduler->addTasks(tasks);
+    double seconds = (boost::posix_time::microsec_clock::local_time() - start)
+    .total_microseconds() / 1000000.0;
+
+    std::vector<ImportError> &errors = importer.getErrors();
+    for (int i = 0; i < errors.size() && i < MAX_IMPORT_ERRORS_SHOWN; i++) {
+        std::string message;
+        switch (errors[i].code) {
+            case ImportError::FIELD_COUNT:
+                message = strings[STRING_FIELD_COUNT_ERROR];
+                break;
+            case ImportError::INVALID_DATE:
+                message = strings[STRING_INVALID_DATE_ERROR];
+                break;
+            case ImportError::INVALID_DURATION:
+                message = strings[STRING_INVALID_DURATION_ERROR];
+                break;
+            case ImportError::INVALID_INTERVAL:
+                message = strings[STRING_INVALID_INTERVAL_ERROR];
+                break;
+            case ImportError::MISSING_PROPERTY:
+                message = strings[STRING_MISSING_PROPERTY_ERROR];
+                break;
+            case ImportError::UNTERMINATED:
+                message = strings[STRING_UNTERMINATED_COMPONENT_ERROR];
+                break;
+            case ImportError::STRAY_QUOTE:
+                message = strings[STRING_STRAY_QUOTE_ERROR];
+                break;
+        }
+        std::cout << strings[STRING_LINE] << " " << errors[i].line << ": "
+        << message << std::endl;
+    }
+    if (errors.size() > MAX_IMPORT_ERRORS_SHOWN) {
+        std::cout << errors.size() - MAX_IMPORT_ERRORS_SHOWN << " "
+        << strings[STRING_MORE_ERRORS] << std::endl;
     }
+
+    std::cout << strings[STRING_IMPORTED] << " " << tasks.size() << " "
+    << strings[STRING_TASKS_IN] << " " << seconds << " "
+    << strings[STRING_SECONDS]
+    << " (" << (long)(seconds > 0 ? tasks.size() / seconds : tasks.size())
+    << " " << strings[STRING_TASKS_PER_SECOND] << ", "
+    << (long)(seconds > 0 ? importer.getBytes() / seconds / 1000000 : 0)
+    << " " << strings[STRING_MEGABYTES_PER_SECOND] << ")" << std::endl;
 }
 
 /* Loop through options for working with a selected task. */
@@ -433,7 +563,7 @@ void deleteTask(Scheduler *scheduler, int id) {
         scheduler->deleteTask(id);
     }
     catch (...) {
-        std::cout << strings["invalid-task-error"] << std::endl;
+        std::cout << strings[STRING_INVALID_TASK_ERROR] << std::endl;
     }
 }
 
@@ -441,13 +571,17 @@ void deleteTask(Scheduler *scheduler, int id) {
 void printTask(Scheduler *scheduler, int id) {
     try {
         Task *task = scheduler->getTask(id);
+        // Show where the task came from when several files are open.
+        if (scheduler->getFileCount() > 1) {
+            std::cout << scheduler->getTaskFilename(id) << std::endl;
+        }
         std::cout << task->getTitle() << std::endl
         << task->getNotes() << std::endl
         << buildIntervalString(task->getInterval()) << std::endl
         << *task->getDuration() << std::endl;
     }
     catch (...) {
-        std::cout << strings["invalid-task-error"] << std::endl;
+        std::cout << strings[STRING_INVALID_TASK_ERROR] << std::endl;
     }
 }
 
@@ -455,8 +589,58 @@ void printTask(Scheduler *scheduler, int id) {
 void spawnTask(Scheduler *scheduler, int parentId) {
 }
 
-/* Generate and display a schedule for the working interval. */
+/* 
+ * Generate and display a schedule for the working interval. Each slot is
+ * printed as soon as it is computed.
+ */
 void generateSchedule(Scheduler *scheduler) {
+    ScheduleGenerator generator(scheduler->getTaskList(),
+                                *scheduler->getWorkingInterval());
+    ScheduleSlot slot;
+    while (generator.next(slot)) {
+        std::cout << buildIntervalString(&slot.period) << "\t" << slot.id
+        << "\t" << slot.task->getTitle() << std::endl;
+    }
+}
+
+/*
+ * Start or stop watching the tasks for alerts. While alerts are on, they are
+ * raised in the background for as long as the session runs.
+ */
+void toggleAlerts(Scheduler *scheduler) {
+    if (monitor != NULL) {
+        scheduler->setDeadlineMonitor(NULL);
+        delete monitor;
+        monitor = NULL;
+        std::cout << strings[STRING_ALERTS_OFF] << std::endl;
+        return;
+    }
+
+    int leadMinutes = DEFAULT_ALERT_LEAD;
+    const char *leadString = getenv(ALERT_LEAD_VARIABLE);
+    if (leadString != NULL) {
+        try {
+            leadMinutes = boost::lexical_cast<int>(leadString);
+        }
+        catch (...) {
+            std::cout << strings[STRING_INVALID_INPUT_ERROR] << std::endl;
+            return;
+        }
+    }
+    const char *hookCommand = getenv(ALERT_HOOK_VARIABLE);
+    monitor = new DeadlineMonitor(boost::posix_time::minutes(leadMinutes),
+                                  hookCommand != NULL ? hookCommand : "");
+    scheduler->setDeadlineMonitor(monitor);
+    std::cout << strings[STRING_ALERTS_ON] << std::endl;
+}
+
+/* Show the latency histograms and counters collected so far. */
+void showStats() {
+#ifdef TIMEFIELD_STATS
+    Stats::print(std::cout);
+#else
+    std::cout << strings[STRING_STATS_DISABLED_ERROR] << std::endl;
+#endif
 }
 
 /* Show a help file. */
@@ -475,19 +659,19 @@ void showHelp() {
     }
 }
 
-/* Load strings from an XML file into a map. */
-void loadStrings() {
-    boost::property_tree::ptree pt;
-    std::stringstream stringsPath;
-    stringsPath << cwd << STRINGS_FILENAME;
-    read_xml(stringsPath.str(), pt);
-    BOOST_FOREACH(boost::property_tree::ptree::value_type &v, 
-                  pt.get_child("strings"))
-    if (v.first == "string") {        
-        std::string key = v.second.get<std::string>("<xmlattr>.name");
-        std::string value = v.second.data();
-        strings[key] = value;
+/*
+ * Find the locale for messages from the environment, in the same order of
+ * precedence as setlocale().
+ */
+const char *getLocale() {
+    const char *variables[] = { "LC_ALL", "LC_MESSAGES", "LANG" };
+    for (int i = 0; i < sizeof(variables) / sizeof(variables[0]); i++) {
+        const char *locale = getenv(variables[i]);
+        if (locale != NULL && *locale != '\0') {
+            return locale;
+        }
     }
+    return NULL;
 }
 
 // Builds a string to output on the command prompt
@@ -585,7 +769,7 @@ int getTaskId (std::string input) {
         id = boost::lexical_cast<int>(idString);
     }
     catch (...) {
-        std::cout << strings["invalid-task-error"] << std::endl;
+        std::cout << strings[STRING_INVALID_TASK_ERROR] << std::endl;
     }
     return id;
 }